@@ -0,0 +1,419 @@
+#ifndef _CONSTRUCTION_H
+#define _CONSTRUCTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "random.h"
+#include "tsp_file.h"
+
+/**
+ * The Construction class builds initial tours for the three solvers.
+ *
+ * - random: Fisher-Yates shuffle, O(n)
+ * - nn: nearest neighbour from a start city; the nearest unvisited city is
+ *   found in a grid of the coordinates, from which visited cities are removed
+ * - greedy: the shortest candidate edges (10 nearest neighbours of each city)
+ *   are added as long as no city gets three edges and no cycle is closed
+ *   (Kruskal with a union-find), then the fragments are joined end to end
+ * - sfc: cities sorted by their index along a Hilbert curve
+ * - savings: Clarke-Wright savings around the city nearest to the centroid,
+ *   on the same candidate edges, the fragments being joined as for greedy
+ *
+ * Apart from the sort of the candidate edges, O(n log n), the grid searches
+ * only visit a few cells each for evenly spread cities. The lengths of the
+ * edges are read from the distance matrix of the solver, so that the tours
+ * follow its rounding.
+ */
+class Construction {
+    public:
+        enum Method {
+            RANDOM,
+            NEAREST_NEIGHBOR,
+            GREEDY,
+            SPACE_FILLING_CURVE,
+            SAVINGS
+        };
+
+        /**
+         * @param name Name of the method: random, nn, greedy, sfc or savings
+         * @param method Method read
+         * @return false if the name is unknown
+         */
+        static bool parse(const std::string& name, Method& method) {
+            static const char* names[] = { "random", "nn", "greedy", "sfc", "savings" };
+            for (int m = 0; m < 5; m++)
+                if (name == names[m]) {
+                    method = Method(m);
+                    return true;
+                }
+            return false;
+        }
+
+        /**
+         * Random tour starting with city 0 (Fisher-Yates shuffle of the others).
+         * @param tour Array of the n cities in visiting order
+         * @param n Number of cities
+         */
+        static void random_tour(int *tour, int n) {
+            for (int i = 0; i < n; i++)
+                tour[i] = i;
+            for (int i = n - 1; i > 1; i--)
+                std::swap(tour[i], tour[1 + Random::random(i)]);
+        }
+
+        /**
+         * Builds a tour.
+         * @param method Construction method
+         * @param cities Coordinates of the cities
+         * @param d Distance matrix
+         * @param tour Array of the n cities in visiting order
+         * @param start Start city of the nearest neighbour tour
+         */
+        template <typename T>
+        static void build(Method method, const std::vector<City>& cities, const T* const* d, int *tour, int start = 0) {
+            int n = (int)cities.size();
+            if (method == RANDOM || n < 4) {
+                random_tour(tour, n);
+                return;
+            }
+            if (method == SPACE_FILLING_CURVE) {
+                hilbert_order(cities, tour);
+                return;
+            }
+            if (method == NEAREST_NEIGHBOR) {
+                Grid grid(cities);
+                tour[0] = start;
+                grid.remove(start);
+                for (int i = 1; i < n; i++) {
+                    tour[i] = grid.nearest(cities[tour[i - 1]]);
+                    grid.remove(tour[i]);
+                }
+                return;
+            }
+
+            // candidate edges, each once
+            Grid grid(cities);
+            std::vector<std::pair<int, int> > edges;
+            std::vector<std::vector<int> > lists(n);
+            for (int c = 0; c < n; c++)
+                grid.k_nearest(c, std::min(10, n - 1), lists[c]);
+            for (int c = 0; c < n; c++)
+                for (size_t k = 0; k < lists[c].size(); k++) {
+                    int o = lists[c][k];
+                    if (c < o || std::find(lists[o].begin(), lists[o].end(), c) == lists[o].end())
+                        edges.push_back(std::make_pair(std::min(c, o), std::max(c, o)));
+                }
+
+            int hub = -1;
+            if (method == GREEDY) {
+                std::sort(edges.begin(), edges.end(), ShorterEdge<T>(d));
+            } else {
+                // savings of the edges not touching the hub, largest first
+                double x = 0, y = 0;
+                for (int c = 0; c < n; c++) {
+                    x += cities[c].x / n;
+                    y += cities[c].y / n;
+                }
+                City centroid = { x, y };
+                hub = grid.nearest(centroid);
+                std::sort(edges.begin(), edges.end(), LargerSaving<T>(d, hub));
+            }
+
+            // edges added while no city has three edges and no cycle is closed
+            std::vector<int> adj(2 * n, -1), parent(n);
+            for (int c = 0; c < n; c++)
+                parent[c] = c;
+            for (size_t k = 0; k < edges.size(); k++) {
+                int a = edges[k].first, b = edges[k].second;
+                if (a == hub || b == hub || adj[2 * a + 1] >= 0 || adj[2 * b + 1] >= 0)
+                    continue;
+                int ra = find(parent, a), rb = find(parent, b);
+                if (ra == rb)
+                    continue;
+                parent[ra] = rb;
+                link(adj, a, b);
+            }
+            join_fragments(cities, adj, start);
+
+            // tour from the adjacency lists
+            int prev = -1, cur = 0;
+            for (int i = 0; i < n; i++) {
+                tour[i] = cur;
+                int next = (adj[2 * cur] != prev) ? adj[2 * cur] : adj[2 * cur + 1];
+                prev = cur;
+                cur = next;
+            }
+        }
+
+    private:
+        /**
+         * Uniform grid over the bounding box of the cities, with about two
+         * cities per cell. Removed cities are no longer found by nearest().
+         */
+        class Grid {
+            public:
+                Grid(const std::vector<City>& cities) : cities(cities) {
+                    int n = (int)cities.size();
+                    min_x = max_x = cities[0].x;
+                    min_y = max_y = cities[0].y;
+                    for (int c = 1; c < n; c++) {
+                        min_x = std::min(min_x, cities[c].x);
+                        max_x = std::max(max_x, cities[c].x);
+                        min_y = std::min(min_y, cities[c].y);
+                        max_y = std::max(max_y, cities[c].y);
+                    }
+                    int side = std::max(1, (int)std::sqrt(n / 2.0));
+                    cell = std::max(std::max(max_x - min_x, max_y - min_y) / side, 1e-9);
+                    width = std::min(side, (int)((max_x - min_x) / cell)) + 1;
+                    height = std::min(side, (int)((max_y - min_y) / cell)) + 1;
+
+                    // cities sorted by cell, each cell keeping its alive cities first
+                    std::vector<int> cell_of(n);
+                    start.assign(width * height + 1, 0);
+                    for (int c = 0; c < n; c++) {
+                        cell_of[c] = cell_x(cities[c].x) + width * cell_y(cities[c].y);
+                        start[cell_of[c] + 1]++;
+                    }
+                    for (int k = 0; k < width * height; k++)
+                        start[k + 1] += start[k];
+                    alive.assign(start.begin(), start.end() - 1);
+                    items.resize(n);
+                    index.resize(n);
+                    for (int c = 0; c < n; c++) {
+                        index[c] = alive[cell_of[c]]++;
+                        items[index[c]] = c;
+                    }
+                    // alive[k] = end of the alive cities of cell k
+                }
+
+                void remove(int c) {
+                    int k = cell_x(cities[c].x) + width * cell_y(cities[c].y);
+                    int last = --alive[k];
+                    int moved = items[last];
+                    items[index[c]] = moved;
+                    index[moved] = index[c];
+                    items[last] = c;
+                    index[c] = last;
+                }
+
+                /**
+                 * @return Nearest alive city to the point p, -1 if none
+                 */
+                int nearest(const City& p) const {
+                    int best = -1;
+                    double best_d2 = 0;
+                    int cx = cell_x(p.x), cy = cell_y(p.y);
+                    for (int r = 0; r <= std::max(width, height); r++) {
+                        for (int y = cy - r; y <= cy + r; y++) {
+                            if (y < 0 || y >= height)
+                                continue;
+                            int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+                            for (int x = cx - r; x <= cx + r; x += std::max(step, 1)) {
+                                if (x < 0 || x >= width)
+                                    continue;
+                                int k = x + width * y;
+                                for (int i = start[k]; i < alive[k]; i++) {
+                                    double d2 = dist2(p, cities[items[i]]);
+                                    if (best < 0 || d2 < best_d2 || (d2 == best_d2 && items[i] < best)) {
+                                        best = items[i];
+                                        best_d2 = d2;
+                                    }
+                                }
+                            }
+                        }
+                        // the cells of the next rings are at least r cells away
+                        if (best >= 0 && best_d2 < (r * cell) * (r * cell))
+                            break;
+                    }
+                    return best;
+                }
+
+                /**
+                 * k nearest cities of city c (alive or not), nearest first.
+                 */
+                void k_nearest(int c, int k, std::vector<int>& out) const {
+                    std::vector<std::pair<double, int> > heap;
+                    const City& p = cities[c];
+                    int cx = cell_x(p.x), cy = cell_y(p.y);
+                    for (int r = 0; r <= std::max(width, height); r++) {
+                        for (int y = cy - r; y <= cy + r; y++) {
+                            if (y < 0 || y >= height)
+                                continue;
+                            int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+                            for (int x = cx - r; x <= cx + r; x += std::max(step, 1)) {
+                                if (x < 0 || x >= width)
+                                    continue;
+                                int cell_index = x + width * y;
+                                for (int i = start[cell_index]; i < start[cell_index + 1]; i++) {
+                                    int o = items[i];
+                                    if (o == c)
+                                        continue;
+                                    std::pair<double, int> entry(dist2(p, cities[o]), o);
+                                    if ((int)heap.size() < k) {
+                                        heap.push_back(entry);
+                                        std::push_heap(heap.begin(), heap.end());
+                                    } else if (entry < heap.front()) {
+                                        std::pop_heap(heap.begin(), heap.end());
+                                        heap.back() = entry;
+                                        std::push_heap(heap.begin(), heap.end());
+                                    }
+                                }
+                            }
+                        }
+                        if ((int)heap.size() == k && heap.front().first < (r * cell) * (r * cell))
+                            break;
+                    }
+                    std::sort_heap(heap.begin(), heap.end());
+                    out.clear();
+                    for (size_t i = 0; i < heap.size(); i++)
+                        out.push_back(heap[i].second);
+                }
+
+            private:
+                const std::vector<City>& cities;
+                double min_x, max_x, min_y, max_y;
+                double cell;                ///< Width of a cell
+                int width;                  ///< Number of columns
+                int height;                 ///< Number of rows
+                std::vector<int> start;     ///< First index of each cell in items, plus the end
+                std::vector<int> alive;     ///< End of the alive cities of each cell in items
+                std::vector<int> items;     ///< Cities sorted by cell
+                std::vector<int> index;     ///< Index of each city in items
+
+                int cell_x(double x) const { return std::min(width - 1, std::max(0, (int)((x - min_x) / cell))); }
+                int cell_y(double y) const { return std::min(height - 1, std::max(0, (int)((y - min_y) / cell))); }
+                static double dist2(const City& a, const City& b) {
+                    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+                }
+        };
+
+        template <typename T>
+        struct ShorterEdge {
+            const T* const* d;
+            ShorterEdge(const T* const* d) : d(d) {}
+            bool operator()(const std::pair<int, int>& e, const std::pair<int, int>& f) const {
+                T de = d[e.first][e.second], df = d[f.first][f.second];
+                return de < df || (de == df && e < f);
+            }
+        };
+
+        template <typename T>
+        struct LargerSaving {
+            const T* const* d;
+            int hub;
+            LargerSaving(const T* const* d, int hub) : d(d), hub(hub) {}
+            T saving(const std::pair<int, int>& e) const {
+                return d[hub][e.first] + d[hub][e.second] - d[e.first][e.second];
+            }
+            bool operator()(const std::pair<int, int>& e, const std::pair<int, int>& f) const {
+                T se = saving(e), sf = saving(f);
+                return se > sf || (se == sf && e < f);
+            }
+        };
+
+        static int find(std::vector<int>& parent, int c) {
+            while (parent[c] != c)
+                c = parent[c] = parent[parent[c]];
+            return c;
+        }
+
+        static void link(std::vector<int>& adj, int a, int b) {
+            adj[2 * a + (adj[2 * a] >= 0 ? 1 : 0)] = b;
+            adj[2 * b + (adj[2 * b] >= 0 ? 1 : 0)] = a;
+        }
+
+        /**
+         * Joins the paths of the adjacency lists into one cycle: from the end
+         * of a path, the nearest end of another path is linked to it.
+         */
+        static void join_fragments(const std::vector<City>& cities, std::vector<int>& adj, int start) {
+            int n = (int)cities.size();
+            // other end of the path of each end (itself for an isolated city)
+            std::vector<int> other_end(n, -1);
+            Grid ends(cities);
+            for (int c = 0; c < n; c++) {
+                if (adj[2 * c + 1] >= 0) {
+                    ends.remove(c);
+                    continue;
+                }
+                if (other_end[c] >= 0)
+                    continue;
+                int prev = c, cur = adj[2 * c];
+                if (cur < 0)
+                    cur = c;
+                else
+                    while (adj[2 * cur + 1] >= 0) {
+                        int next = (adj[2 * cur] != prev) ? adj[2 * cur] : adj[2 * cur + 1];
+                        prev = cur;
+                        cur = next;
+                    }
+                other_end[c] = cur;
+                other_end[cur] = c;
+            }
+
+            int first = (other_end[start] >= 0) ? start : -1;
+            for (int c = 0; c < n && first < 0; c++)
+                if (other_end[c] >= 0)
+                    first = c;
+            if (first < 0)
+                return;
+            ends.remove(first);
+            int last = other_end[first];
+            if (last != first)
+                ends.remove(last);
+            for (;;) {
+                int next = ends.nearest(cities[last]);
+                if (next < 0)
+                    break;
+                ends.remove(next);
+                link(adj, last, next);
+                last = other_end[next];
+                if (last != next)
+                    ends.remove(last);
+            }
+            link(adj, last, first);
+        }
+
+        /**
+         * Cities sorted by their index along a Hilbert curve of 2^16 x 2^16 cells.
+         */
+        static void hilbert_order(const std::vector<City>& cities, int *tour) {
+            int n = (int)cities.size();
+            double min_x = cities[0].x, max_x = cities[0].x, min_y = cities[0].y, max_y = cities[0].y;
+            for (int c = 1; c < n; c++) {
+                min_x = std::min(min_x, cities[c].x);
+                max_x = std::max(max_x, cities[c].x);
+                min_y = std::min(min_y, cities[c].y);
+                max_y = std::max(max_y, cities[c].y);
+            }
+            const int side = 1 << 16;
+            double scale = (side - 1) / std::max(std::max(max_x - min_x, max_y - min_y), 1e-9);
+            std::vector<std::pair<uint64_t, int> > keys(n);
+            for (int c = 0; c < n; c++) {
+                int x = (int)((cities[c].x - min_x) * scale);
+                int y = (int)((cities[c].y - min_y) * scale);
+                uint64_t key = 0;
+                for (int s = side / 2; s > 0; s /= 2) {
+                    int rx = (x & s) > 0, ry = (y & s) > 0;
+                    key += (uint64_t)s * s * ((3 * rx) ^ ry);
+                    if (ry == 0) {
+                        if (rx == 1) {
+                            x = side - 1 - x;
+                            y = side - 1 - y;
+                        }
+                        std::swap(x, y);
+                    }
+                }
+                keys[c] = std::make_pair(key, c);
+            }
+            std::sort(keys.begin(), keys.end());
+            for (int i = 0; i < n; i++)
+                tour[i] = keys[i].second;
+        }
+};
+
+#endif
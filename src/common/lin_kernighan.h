@@ -0,0 +1,277 @@
+#ifndef _LIN_KERNIGHAN_H
+#define _LIN_KERNIGHAN_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "tour.h"
+
+/**
+ * The LinKernighan class is a local improvement engine for the symmetric TSP,
+ * shared by the Tabu Search, the Genetic Algorithm and Little's algorithm.
+ *
+ * An improving move is a sequence of 2-opt moves t1 t2 t3 t4 ... sharing the
+ * city t1 (Lin-Kernighan move realised by flips): each step breaks the edge
+ * (t1, t2), joins t2 to one of its nearest neighbours t3 and breaks (t4, t3),
+ * as long as the partial gain stays positive. The sequence is then rolled back
+ * to the step giving the best closed tour. Only the cities whose don't-look
+ * bit is off are used as t1, and the bits are reset around improved edges.
+ * The tour is accessed through the Tour interface, so large instances use
+ * the two-level list and its O(sqrt(n)) flips.
+ *
+ * T is the type of the distances (int or double).
+ */
+template <typename T>
+class LinKernighan {
+    public:
+        /**
+         * Constructor: builds the neighbour lists.
+         * @param distances Distance matrix
+         * @param n Number of cities
+         * @param num_neighbors Number of nearest neighbours considered for t3
+         * @param max_depth Maximum number of 2-opt moves in an improving move
+         */
+        LinKernighan(const T* const* distances, int n, int num_neighbors = 8, int max_depth = 30)
+            : d(distances), n(n), max_depth(max_depth), tour(Tour::create(n)), dont_look(n, 1), queued(n, 0), queue(n) {
+            int k = std::min(num_neighbors, n - 1);
+            std::vector<int> others;
+            neighbors.resize(n);
+            for (int c = 0; c < n; c++) {
+                others.clear();
+                for (int o = 0; o < n; o++)
+                    if (o != c)
+                        others.push_back(o);
+                std::partial_sort(others.begin(), others.begin() + k, others.end(), Closer(d[c]));
+                neighbors[c].assign(others.begin(), others.begin() + k);
+            }
+        }
+
+        ~LinKernighan() {
+            delete tour;
+        }
+
+        /**
+         * Improves a tour until no improving move starts from any city.
+         * @param cities Array of the n cities in visiting order, improved in place
+         * @return Decrease of the length of the tour
+         */
+        T optimize(int *cities) {
+            queue_head = queue_size = 0;
+            for (int c = 0; c < n; c++) {
+                dont_look[c] = 1;
+                queued[c] = 0;
+                activate(c);
+            }
+            return run(cities);
+        }
+
+        /**
+         * Improves a tour, only starting from the given cities at first
+         * (the other don't-look bits are set).
+         * @param cities Array of the n cities in visiting order, improved in place
+         * @param active Cities whose don't-look bit is off
+         * @param num_active Number of active cities
+         * @return Decrease of the length of the tour
+         */
+        T optimize(int *cities, const int *active, int num_active) {
+            queue_head = queue_size = 0;
+            for (int c = 0; c < n; c++) {
+                dont_look[c] = 1;
+                queued[c] = 0;
+            }
+            for (int k = 0; k < num_active; k++)
+                activate(active[k]);
+            return run(cities);
+        }
+
+        /**
+         * @return Neighbour lists, nearest city first
+         */
+        const std::vector<std::vector<int> >& neighbor_lists() const {
+            return neighbors;
+        }
+
+    private:
+        LinKernighan(const LinKernighan&);
+        LinKernighan& operator=(const LinKernighan&);
+
+        /**
+         * Orders cities by increasing distance to a given city.
+         */
+        struct Closer {
+            const T *row;
+            Closer(const T *row) : row(row) {}
+            bool operator()(int u, int v) const { return row[u] < row[v]; }
+        };
+
+        /**
+         * A choice for t3, with t4 the city broken away from it.
+         */
+        struct Candidate {
+            int t3;
+            int t4;
+            T gain;     ///< Partial gain once (t4, t3) is broken
+            bool operator<(const Candidate& other) const { return gain > other.gain; }
+        };
+
+        const T* const* d;                  ///< Distance matrix
+        int n;                              ///< Number of cities
+        int max_depth;                      ///< Maximum number of 2-opt moves per improving move
+        std::vector<std::vector<int> > neighbors; ///< Nearest neighbours of each city
+        Tour *tour;                         ///< Tour being improved
+        std::vector<char> dont_look;        ///< Don't-look bits
+        std::vector<char> queued;           ///< true if the city is in the queue
+        std::vector<int> queue;             ///< Cities whose don't-look bit is off (circular, a city is queued once)
+        int queue_head;                     ///< Index of the first city of the queue
+        int queue_size;                     ///< Number of cities in the queue
+        std::vector<std::pair<int, int> > flips; ///< Flips of the move in progress
+        std::vector<std::pair<int, int> > added; ///< Edges added by the move in progress
+        T best_gain;                        ///< Best closed gain of the move in progress
+        size_t best_flips;                  ///< Number of flips giving best_gain
+
+        /**
+         * Threshold below which a gain is considered null (rounding errors).
+         */
+        static T epsilon() {
+            return T(1e-7);
+        }
+
+        void activate(int c) {
+            dont_look[c] = 0;
+            if (!queued[c]) {
+                queued[c] = 1;
+                int tail = queue_head + queue_size++;
+                queue[tail < n ? tail : tail - n] = c;
+            }
+        }
+
+        T run(int *cities) {
+            T total = T();
+            tour->load(cities);
+            while (queue_size > 0) {
+                int c = queue[queue_head];
+                queue_head = (queue_head + 1 == n) ? 0 : queue_head + 1;
+                queue_size--;
+                queued[c] = 0;
+                T gain = improve_city(c);
+                if (gain > epsilon()) {
+                    total += gain;
+                    activate(c);
+                } else {
+                    dont_look[c] = 1;
+                }
+            }
+            tour->store(cities);
+            return total;
+        }
+
+        /**
+         * Flips the path a..b, read in the given direction.
+         */
+        void make_flip(int a, int b, bool forward) {
+            if (forward) {
+                tour->flip(a, b);
+                flips.push_back(std::make_pair(a, b));
+            } else {
+                tour->flip(b, a);
+                flips.push_back(std::make_pair(b, a));
+            }
+        }
+
+        /**
+         * Undoes the last flips until only 'count' remain.
+         */
+        void undo_to(size_t count) {
+            while (flips.size() > count) {
+                tour->flip(flips.back().second, flips.back().first);
+                flips.pop_back();
+            }
+        }
+
+        bool is_added(int a, int b) const {
+            for (size_t k = 0; k < added.size(); k++)
+                if ((added[k].first == a && added[k].second == b) || (added[k].first == b && added[k].second == a))
+                    return true;
+            return false;
+        }
+
+        /**
+         * Looks for an improving move starting with the edge (t1, t2).
+         * @return Gain of the move applied to the tour, 0 if none
+         */
+        T improve_city(int t1) {
+            for (int dir = 0; dir < 2; dir++) {
+                bool forward = (dir == 0);
+                int t2 = forward ? tour->next(t1) : tour->prev(t1);
+                flips.clear();
+                added.clear();
+                best_gain = T();
+                best_flips = 0;
+                step(0, d[t1][t2], t1, t2, forward);
+                if (best_gain > epsilon()) {
+                    undo_to(best_flips);
+                    // Reset the don't-look bits around the changed edges
+                    activate(t1);
+                    for (size_t k = 0; k < flips.size(); k++) {
+                        activate(flips[k].first);
+                        activate(flips[k].second);
+                        activate(tour->prev(flips[k].first));
+                        activate(tour->next(flips[k].second));
+                    }
+                    return best_gain;
+                }
+                undo_to(0);
+            }
+            return T();
+        }
+
+        /**
+         * One level of the move: t2 follows t1 in the given direction and
+         * 'gain' is the partial gain with the edge (t1, t2) broken.
+         */
+        void step(int level, T gain, int t1, int t2, bool forward) {
+            Candidate candidates[16];
+            int num_candidates = 0;
+            int succ_t2 = forward ? tour->next(t2) : tour->prev(t2);
+            const std::vector<int>& list = neighbors[t2];
+            for (size_t k = 0; k < list.size() && num_candidates < 16; k++) {
+                int t3 = list[k];
+                T g1 = gain - d[t2][t3];
+                // Neighbours are sorted: the partial gain can only decrease
+                if (g1 <= epsilon())
+                    break;
+                if (t3 == t1 || t3 == succ_t2)
+                    continue;
+                int t4 = forward ? tour->prev(t3) : tour->next(t3);
+                if (is_added(t3, t4))
+                    continue;
+                Candidate candidate = { t3, t4, g1 + d[t4][t3] };
+                candidates[num_candidates++] = candidate;
+            }
+            std::sort(candidates, candidates + num_candidates);
+
+            // Backtracking on the first two levels only
+            int breadth = (level == 0) ? 5 : (level == 1 ? 3 : 1);
+            for (int k = 0; k < num_candidates && k < breadth; k++) {
+                int t3 = candidates[k].t3;
+                int t4 = candidates[k].t4;
+                size_t mark = flips.size();
+                // t1 t2 ... t4 t3 becomes t1 t4 ... t2 t3
+                make_flip(t2, t4, forward);
+                added.push_back(std::make_pair(t2, t3));
+                T closed = candidates[k].gain - d[t4][t1];
+                if (closed > best_gain) {
+                    best_gain = closed;
+                    best_flips = flips.size();
+                }
+                if (level + 1 < max_depth)
+                    step(level + 1, candidates[k].gain, t1, t4, forward);
+                if (best_gain > epsilon())
+                    return;
+                added.pop_back();
+                undo_to(mark);
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef _OPTIONS_H
+#define _OPTIONS_H
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * The Options class separates the named options ("--name value" or
+ * "--name=value") from the positional arguments of a command line, so that the
+ * historical positional synopsis of the executables keeps working unchanged.
+ * The flags ("--lk", "--reactive", ...) never take a value, so that a
+ * positional argument may follow them.
+ */
+class Options {
+    public:
+        std::vector<char*> positional;            ///< argv[0] followed by the positional arguments
+        std::map<std::string, std::string> named; ///< Named options without their leading "--"
+
+        /**
+         * Splits the command line.
+         *
+         * @param argc Number of arguments
+         * @param argv Array containing the arguments
+         */
+        Options(int argc, char **argv) {
+            for (int i = 0; i < argc; i++) {
+                if (i > 0 && strncmp(argv[i], "--", 2) == 0 && strlen(argv[i]) > 2) {
+                    std::string name(argv[i] + 2);
+                    size_t equal = name.find('=');
+                    if (equal != std::string::npos)
+                        named[name.substr(0, equal)] = name.substr(equal + 1);
+                    else if (!is_flag(name) && i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+                        named[name] = argv[++i];
+                    else
+                        named[name] = "1";
+                } else {
+                    positional.push_back(argv[i]);
+                }
+            }
+        }
+
+        /**
+         * @param name Name of an option
+         * @return true if the option is a flag, which never takes a value
+         */
+        static bool is_flag(const std::string& name) {
+            static const char *flags[] = { "lk", "reactive", "no-simd", "reject-duplicates" };
+            for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); f++)
+                if (name == flags[f])
+                    return true;
+            return false;
+        }
+
+        /**
+         * @return Number of positional arguments, argv[0] included
+         */
+        int argc() const {
+            return (int)positional.size();
+        }
+
+        /**
+         * @return Positional arguments, argv[0] included
+         */
+        char **argv() {
+            return positional.data();
+        }
+
+        /**
+         * @param name Name of the option
+         * @return true if the option was given
+         */
+        bool has(const std::string& name) const {
+            return named.find(name) != named.end();
+        }
+
+        std::string get(const std::string& name, const std::string& default_value) const {
+            std::map<std::string, std::string>::const_iterator it = named.find(name);
+            return it == named.end() ? default_value : it->second;
+        }
+
+        int get_int(const std::string& name, int default_value) const {
+            return has(name) ? atoi(get(name, "").c_str()) : default_value;
+        }
+
+        double get_double(const std::string& name, double default_value) const {
+            return has(name) ? atof(get(name, "").c_str()) : default_value;
+        }
+
+        /**
+         * Adds the options of a configuration file (as written by the tuning tool)
+         * that are not given on the command line. Each line of the file reads
+         * "algorithm max_cities --name value ...", max_cities being "*" for any size.
+         * The first line of the algorithm whose max_cities is at least the number of
+         * cities applies. Empty lines and lines starting with '#' are ignored.
+         *
+         * @param file_name Name of the configuration file
+         * @param algorithm Name of the algorithm ("tabu" or "genetic")
+         * @param num_cities Number of cities of the instance
+         * @return false if the file cannot be read
+         */
+        bool load_config(const std::string& file_name, const std::string& algorithm, int num_cities) {
+            std::ifstream file(file_name.c_str());
+            if (!file)
+                return false;
+            std::string line;
+            while (getline(file, line)) {
+                std::istringstream iss(line);
+                std::string name, bound;
+                if (!(iss >> name >> bound) || name[0] == '#' || name != algorithm)
+                    continue;
+                if (bound != "*" && atoi(bound.c_str()) < num_cities)
+                    continue;
+                std::vector<std::string> tokens;
+                std::string token;
+                while (iss >> token)
+                    tokens.push_back(token);
+                for (size_t i = 0; i < tokens.size(); i++) {
+                    if (tokens[i].compare(0, 2, "--") != 0)
+                        continue;
+                    std::string option = tokens[i].substr(2);
+                    std::string value = "1";
+                    size_t equal = option.find('=');
+                    if (equal != std::string::npos) {
+                        value = option.substr(equal + 1);
+                        option = option.substr(0, equal);
+                    } else if (!is_flag(option) && i + 1 < tokens.size() && tokens[i + 1].compare(0, 2, "--") != 0) {
+                        value = tokens[++i];
+                    }
+                    // The command line has priority
+                    if (!has(option))
+                        named[option] = value;
+                }
+                break;
+            }
+            return true;
+        }
+};
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * The Random class is the random number generator shared by the solvers.
+ *
+ * Each thread owns a xoshiro256** generator. All the generators derive from
+ * one seed: the generator of stream k starts 2^128 numbers after the one of
+ * stream k - 1 (jump function), so the streams never overlap. With the same
+ * seed and the same streams, a run draws exactly the same numbers; it is
+ * identical only if the threads do not exchange solutions as they go (the
+ * islands of the genetic algorithm receive whichever migrants have arrived).
+ * Bounded integers are drawn without bias with Lemire's method.
+ */
+class Random {
+    public:
+        /**
+         * Sets the seed from which all the streams derive.
+         * Must be called before the threads start.
+         *
+         * @param value Seed
+         */
+        static void set_seed(uint64_t value) {
+            base_seed() = value;
+        }
+
+        /**
+         * @return Seed from which all the streams derive
+         */
+        static uint64_t seed() {
+            return base_seed();
+        }
+
+        /**
+         * Initializes the random number generator of the calling thread.
+         *
+         * @param stream Number of the stream, distinct for each thread
+         */
+        static void randomize(unsigned stream = 0) {
+            uint64_t *s = state();
+            uint64_t x = base_seed();
+            for (int i = 0; i < 4; i++)
+                s[i] = splitmix64(x);
+            for (unsigned k = 0; k < stream; k++)
+                jump();
+        }
+
+        /**
+         * @return 64 random bits
+         */
+        static uint64_t next() {
+            uint64_t *s = state();
+            uint64_t result = rotl(s[1] * 5, 7) * 9;
+            uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+
+        /**
+         * Returns a random integer between 0 and (bound - 1).
+         * 
+         * @param bound The upper bound for the random number (exclusive), below 2^32
+         * @return A random integer between 0 and (bound - 1)
+         */
+        static long random(long bound) {
+            uint32_t range = (uint32_t)bound;
+            uint64_t m = (uint64_t)(uint32_t)(next() >> 32) * range;
+            uint32_t low = (uint32_t)m;
+            // Reject the few values that would make some results more likely
+            if (low < range) {
+                uint32_t threshold = (uint32_t)(-range) % range;
+                while (low < threshold) {
+                    m = (uint64_t)(uint32_t)(next() >> 32) * range;
+                    low = (uint32_t)m;
+                }
+            }
+            return (long)(m >> 32);
+        }
+
+        /**
+         * @return A random real in [0, 1)
+         */
+        static double uniform() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /**
+         * @return A seed taken from the clock, for the runs without --seed
+         */
+        static uint64_t clock_seed() {
+            return (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        }
+
+    private:
+        static uint64_t& base_seed() {
+            static uint64_t value = 0;
+            return value;
+        }
+
+        static uint64_t *state() {
+            static thread_local uint64_t s[4] = { 1, 2, 3, 4 };
+            return s;
+        }
+
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        static uint64_t splitmix64(uint64_t& x) {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * Advances the generator of the calling thread by 2^128 numbers.
+         */
+        static void jump() {
+            static const uint64_t polynomial[4] = {
+                0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+            };
+            uint64_t *s = state();
+            uint64_t t[4] = { 0, 0, 0, 0 };
+            for (int i = 0; i < 4; i++)
+                for (int b = 0; b < 64; b++) {
+                    if (polynomial[i] & ((uint64_t)1 << b))
+                        for (int k = 0; k < 4; k++)
+                            t[k] ^= s[k];
+                    next();
+                }
+            for (int k = 0; k < 4; k++)
+                s[k] = t[k];
+        }
+};
+
+#endif
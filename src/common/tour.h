@@ -0,0 +1,405 @@
+#ifndef _TOUR_H
+#define _TOUR_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * The Tour class is the interface of the tour representations used by the
+ * move operators: the cycle can be walked with next() and prev(), queried
+ * with between() and modified with flip(), without knowing how it is stored.
+ * The operators only rely on the cycle, not on the index of the cities.
+ * It serves the searches that apply many moves to one tour (tabu search,
+ * Lin-Kernighan); the operators of the genetic algorithm apply one or two
+ * changes to each child and stay on its genes array.
+ */
+class Tour {
+    public:
+        virtual ~Tour() {}
+
+        /**
+         * @return Number of cities
+         */
+        virtual int size() const = 0;
+
+        /**
+         * Loads a tour
+         * @param cities Array of the n cities in visiting order
+         */
+        virtual void load(const int *cities) = 0;
+
+        /**
+         * Stores the tour in visiting order
+         * @param cities Array receiving the n cities
+         */
+        virtual void store(int *cities) const = 0;
+
+        /**
+         * @param c City
+         * @return City visited after c
+         */
+        virtual int next(int c) const = 0;
+
+        /**
+         * @param c City
+         * @return City visited before c
+         */
+        virtual int prev(int c) const = 0;
+
+        /**
+         * @return true if b is met when going from a to c following next()
+         */
+        virtual bool between(int a, int b, int c) const = 0;
+
+        /**
+         * Reverses the path going from a to b following next().
+         * Afterwards, the path goes from b to a.
+         */
+        virtual void flip(int a, int b) = 0;
+
+        /**
+         * Creates the representation best suited to the number of cities:
+         * an array for small instances, a two-level list from 'two_level_threshold' cities.
+         * @param n Number of cities
+         * @return Tour to be deleted by the caller
+         */
+        static Tour *create(int n);
+
+        static const int two_level_threshold = 10000;
+};
+
+/**
+ * The ArrayTour class stores a tour as an array of cities together with the
+ * inverse index (position of each city), so that next(), prev() and between()
+ * are O(1). A reversal bit lets flip() reverse whichever side of the tour is
+ * the shortest, so a flip costs at most n/2 exchanges.
+ */
+class ArrayTour final : public Tour {
+    public:
+        /**
+         * Constructor
+         * @param n Number of cities
+         */
+        ArrayTour(int n) : n(n), order(n), pos(n), reversed(false) {
+            for (int i = 0; i < n; i++)
+                order[i] = pos[i] = i;
+        }
+
+        void load(const int *cities) override {
+            reversed = false;
+            for (int i = 0; i < n; i++) {
+                order[i] = cities[i];
+                pos[cities[i]] = i;
+            }
+        }
+
+        void store(int *cities) const override {
+            for (int i = 0; i < n; i++)
+                cities[i] = reversed ? order[(n - i) % n] : order[i];
+        }
+
+        int size() const override {
+            return n;
+        }
+
+        int next(int c) const override {
+            int i = reversed ? pos[c] - 1 : pos[c] + 1;
+            return order[i < 0 ? n - 1 : (i == n ? 0 : i)];
+        }
+
+        int prev(int c) const override {
+            int i = reversed ? pos[c] + 1 : pos[c] - 1;
+            return order[i < 0 ? n - 1 : (i == n ? 0 : i)];
+        }
+
+        bool between(int a, int b, int c) const override {
+            int ab = reversed ? pos[a] - pos[b] : pos[b] - pos[a];
+            int ac = reversed ? pos[a] - pos[c] : pos[c] - pos[a];
+            if (ab < 0) ab += n;
+            if (ac < 0) ac += n;
+            return ab <= ac;
+        }
+
+        void flip(int a, int b) override {
+            int i = reversed ? pos[b] : pos[a];
+            int j = reversed ? pos[a] : pos[b];
+            int length = j - i;
+            if (length < 0) length += n;
+            length++;
+            // Reversing the complementary path gives the same cycle in the
+            // opposite direction, which the reversal bit compensates
+            if (2 * length > n) {
+                i = (j + 1 == n) ? 0 : j + 1;
+                length = n - length;
+                j = i + length - 1;
+                if (j >= n) j -= n;
+                reversed = !reversed;
+            }
+            for (int k = 0; k < length / 2; k++) {
+                int ci = order[i], cj = order[j];
+                order[i] = cj; pos[cj] = i;
+                order[j] = ci; pos[ci] = j;
+                i = (i + 1 == n) ? 0 : i + 1;
+                j = (j == 0) ? n - 1 : j - 1;
+            }
+        }
+
+    private:
+        int n;                  ///< Number of cities
+        std::vector<int> order; ///< order[i] = city stored at index i
+        std::vector<int> pos;   ///< pos[c] = index of city c in order
+        bool reversed;          ///< true if the tour is read from right to left
+};
+
+/**
+ * The TwoLevelListTour class splits the tour into about sqrt(n) segments.
+ * Each segment holds its cities and a reversal bit, and the segments are kept
+ * in a list ordered along the tour. A flip splits at most two segments at the
+ * ends of the path, then reverses the order of the segments in between and
+ * toggles their bits, which costs O(sqrt(n)) instead of O(n).
+ * The segments are rebuilt when splits have made them too numerous. As they
+ * are never merged, there are at most max_segments of them, each of at most
+ * group_size cities: their storage is allocated once by the constructor, so
+ * that neither a flip nor a rebuild allocates memory.
+ */
+class TwoLevelListTour final : public Tour {
+    public:
+        /**
+         * Constructor
+         * @param n Number of cities
+         */
+        TwoLevelListTour(int n) : n(n), city_segment(n), city_index(n), scratch(n), reversed(false) {
+            group_size = std::max(1, (int)std::sqrt((double)n));
+            // A flip adds at most two segments to the max_segments - 2 which trigger a rebuild
+            max_segments = 4 * (n / group_size + 1) + 2;
+            segment_cities.resize(max_segments);
+            for (int s = 0; s < max_segments; s++)
+                segment_cities[s].reserve(group_size);
+            segment_reversed.resize(max_segments);
+            segment_rank.resize(max_segments);
+            segment_order.reserve(max_segments);
+            for (int i = 0; i < n; i++)
+                scratch[i] = i;
+            load(scratch.data());
+        }
+
+        void load(const int *cities) override {
+            reversed = false;
+            segment_order.clear();
+            for (int start = 0; start < n; start += group_size) {
+                int s = (int)segment_order.size();
+                int end = std::min(n, start + group_size);
+                segment_cities[s].assign(cities + start, cities + end);
+                segment_reversed[s] = false;
+                segment_rank[s] = s;
+                segment_order.push_back(s);
+                for (int i = start; i < end; i++) {
+                    city_segment[cities[i]] = s;
+                    city_index[cities[i]] = i - start;
+                }
+            }
+        }
+
+        void store(int *cities) const override {
+            int c = first_city(segment_order[0]);
+            for (int i = 0; i < n; i++) {
+                cities[i] = c;
+                c = next(c);
+            }
+        }
+
+        int size() const override {
+            return n;
+        }
+
+        int next(int c) const override {
+            return reversed ? pred(c) : succ(c);
+        }
+
+        int prev(int c) const override {
+            return reversed ? succ(c) : pred(c);
+        }
+
+        bool between(int a, int b, int c) const override {
+            return reversed ? forward_between(c, b, a) : forward_between(a, b, c);
+        }
+
+        void flip(int a, int b) override {
+            if (reversed)
+                forward_flip(b, a);
+            else
+                forward_flip(a, b);
+            // Too many segments after the splits: rebuild them
+            if ((int)segment_order.size() > max_segments - 2) {
+                store(scratch.data());
+                load(scratch.data());
+            }
+        }
+
+    private:
+        int n;                                   ///< Number of cities
+        int group_size;                          ///< Number of cities per segment when (re)built
+        int max_segments;                        ///< Number of segments allocated
+        std::vector<std::vector<int> > segment_cities; ///< Cities of each segment, in storage order
+        std::vector<char> segment_reversed;      ///< true if the segment is read from right to left
+        std::vector<int> segment_rank;           ///< Rank of each segment in segment_order
+        std::vector<int> segment_order;          ///< Segments in the order of the tour
+        std::vector<int> city_segment;           ///< Segment holding each city
+        std::vector<int> city_index;             ///< Index of each city in its segment
+        std::vector<int> scratch;                ///< Cities of the tour when the segments are rebuilt
+        bool reversed;                           ///< true if the whole tour is read backwards
+
+        /**
+         * @return Rank of the city inside its segment, in the order of the tour
+         */
+        int rank_in_segment(int c) const {
+            int s = city_segment[c];
+            return segment_reversed[s] ? (int)segment_cities[s].size() - 1 - city_index[c] : city_index[c];
+        }
+
+        /**
+         * @return City of rank k inside segment s, in the order of the tour
+         */
+        int city_at(int s, int k) const {
+            return segment_reversed[s] ? segment_cities[s][segment_cities[s].size() - 1 - k] : segment_cities[s][k];
+        }
+
+        int first_city(int s) const {
+            return city_at(s, 0);
+        }
+
+        int last_city(int s) const {
+            return city_at(s, (int)segment_cities[s].size() - 1);
+        }
+
+        int succ(int c) const {
+            int s = city_segment[c];
+            int k = rank_in_segment(c);
+            if (k + 1 < (int)segment_cities[s].size())
+                return city_at(s, k + 1);
+            int r = segment_rank[s] + 1;
+            return first_city(segment_order[r == (int)segment_order.size() ? 0 : r]);
+        }
+
+        int pred(int c) const {
+            int s = city_segment[c];
+            int k = rank_in_segment(c);
+            if (k > 0)
+                return city_at(s, k - 1);
+            int r = segment_rank[s] - 1;
+            return last_city(segment_order[r < 0 ? (int)segment_order.size() - 1 : r]);
+        }
+
+        /**
+         * @return Offset of c from a, following succ()
+         */
+        long offset(int a, int c) const {
+            long ra = (long)segment_rank[city_segment[a]] * n + rank_in_segment(a);
+            long rc = (long)segment_rank[city_segment[c]] * n + rank_in_segment(c);
+            long total = (long)segment_order.size() * n;
+            return rc >= ra ? rc - ra : rc - ra + total;
+        }
+
+        bool forward_between(int a, int b, int c) const {
+            return offset(a, b) <= offset(a, c);
+        }
+
+        /**
+         * Splits the segment of c so that c becomes the first city of a segment.
+         */
+        void split_before(int c) {
+            int s = city_segment[c];
+            int k = rank_in_segment(c);
+            if (k == 0)
+                return;
+            std::vector<int>& cities = segment_cities[s];
+            int length = (int)cities.size();
+            // The cities of rank k.. move, in the order of the tour, to the next unused segment
+            int t = (int)segment_order.size();
+            std::vector<int>& moved = segment_cities[t];
+            moved.clear();
+            for (int i = k; i < length; i++)
+                moved.push_back(city_at(s, i));
+            if (segment_reversed[s]) {
+                // Ranks 0..k-1 are stored at the end of the segment
+                cities.erase(cities.begin(), cities.begin() + (length - k));
+                for (int i = 0; i < k; i++)
+                    city_index[cities[i]] = i;
+            } else {
+                cities.resize(k);
+            }
+            segment_reversed[t] = false;
+            for (int i = 0; i < length - k; i++) {
+                city_segment[moved[i]] = t;
+                city_index[moved[i]] = i;
+            }
+            segment_order.insert(segment_order.begin() + segment_rank[s] + 1, t);
+            for (int r = segment_rank[s] + 1; r < (int)segment_order.size(); r++)
+                segment_rank[segment_order[r]] = r;
+        }
+
+        /**
+         * Reverses the segments of ranks first..last (wrapping around) and toggles their bits.
+         */
+        void reverse_segments(int first, int last) {
+            int count = (int)segment_order.size();
+            int length = last - first;
+            if (length < 0) length += count;
+            length++;
+            int i = first, j = last;
+            for (int k = 0; k < length / 2; k++) {
+                std::swap(segment_order[i], segment_order[j]);
+                segment_rank[segment_order[i]] = i;
+                segment_rank[segment_order[j]] = j;
+                i = (i + 1 == count) ? 0 : i + 1;
+                j = (j == 0) ? count - 1 : j - 1;
+            }
+            for (int k = 0, r = first; k < length; k++, r = (r + 1 == count) ? 0 : r + 1)
+                segment_reversed[segment_order[r]] = !segment_reversed[segment_order[r]];
+        }
+
+        /**
+         * Reverses the path from a to b following succ().
+         */
+        void forward_flip(int a, int b) {
+            if (a == b)
+                return;
+            int s = city_segment[a];
+            int ka = rank_in_segment(a), kb = rank_in_segment(b);
+            // Path inside one segment: reverse it in place
+            if (city_segment[b] == s && ka < kb) {
+                for (int i = ka, j = kb; i < j; i++, j--) {
+                    int ci = city_at(s, i), cj = city_at(s, j);
+                    std::swap(segment_cities[s][city_index[ci]], segment_cities[s][city_index[cj]]);
+                    std::swap(city_index[ci], city_index[cj]);
+                }
+                return;
+            }
+            int after_b = succ(b);
+            split_before(a);
+            if (after_b != a)
+                split_before(after_b);
+            int first = segment_rank[city_segment[a]];
+            int last = segment_rank[city_segment[b]];
+            int count = (int)segment_order.size();
+            int length = last - first;
+            if (length < 0) length += count;
+            length++;
+            // Reversing the other segments gives the same cycle backwards
+            if (2 * length > count && length < count) {
+                reverse_segments((last + 1) % count, (first - 1 + count) % count);
+                reversed = !reversed;
+            } else {
+                reverse_segments(first, last);
+            }
+        }
+};
+
+inline Tour *Tour::create(int n) {
+    if (n >= two_level_threshold)
+        return new TwoLevelListTour(n);
+    return new ArrayTour(n);
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef _TOUR_HASH_H
+#define _TOUR_HASH_H
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Hash of a tour independent of its starting city and of its direction:
+ * the XOR of a 64-bit key per edge. The key of an edge only depends on its
+ * two cities, so a move changes the hash by the keys of the edges it removes
+ * and adds, in O(1).
+ */
+class TourHash {
+    public:
+        /**
+         * @return Key of the edge (a, b), equal to the key of (b, a)
+         */
+        static uint64_t edge_key(int a, int b) {
+            uint64_t low = (uint64_t)std::min(a, b), high = (uint64_t)std::max(a, b);
+            uint64_t z = (high << 32 | low) + 0x9e3779b97f4a7c15ULL;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @param cities Array of the n cities in visiting order
+         * @param n Number of cities
+         * @return Hash of the tour
+         */
+        static uint64_t of(const int *cities, int n) {
+            uint64_t hash = edge_key(cities[n - 1], cities[0]);
+            for (int i = 0; i + 1 < n; i++)
+                hash ^= edge_key(cities[i], cities[i + 1]);
+            return hash;
+        }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef _TSP_FILE_H
+#define _TSP_FILE_H
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * This structure defines a city with its coordinates.
+ */
+struct City {
+    double x;
+    double y;
+};
+
+/**
+ * @brief Load the coordinates of cities from a TSP file
+ * 
+ * @param file_path path to the TSP file
+ * @param cities vector to store the coordinates of cities
+ * @return the dimension (number of cities)
+ */ 
+inline int load_tsp_coordinates(const std::string& file_path, std::vector<City>& cities) {
+    std::ifstream file(file_path);
+    if (!file) {
+        std::cerr << "Unable to load the file " << file_path << "\n";
+        exit(1);
+    }
+
+    std::string line;
+    int dimension = 0;
+
+    // Read the dimension and coordinates
+    while (getline(file, line)) {
+        if (line.find("DIMENSION") != std::string::npos) {
+            std::istringstream iss(line);
+            std::string temp;
+            while (iss >> temp) {
+                if (isdigit(temp[0])) {
+                    dimension = stoi(temp);
+                    break;
+                }
+            }
+        }
+        if (line == "NODE_COORD_SECTION") {
+            break;
+        }
+    }
+
+    cities.resize(dimension);
+
+    int id;
+    double x, y;
+    for (int i = 0; i < dimension; ++i) {
+        file >> id >> x >> y;
+        cities[id - 1] = {x, y}; // Make sure the IDs start from 1
+    }
+
+    file.close();
+    return dimension;
+}
+
+/**
+ * @brief Calculate the Euclidean distance between two cities
+ * 
+ * @param a city a
+ * @param b city b
+ * @return the Euclidean distance between a and b
+ */
+inline double euclidean_distance(const City& a, const City& b) {
+    return sqrt(pow(a.x - b.x, 2) + pow(a.y - b.y, 2));
+}
+
+#endif
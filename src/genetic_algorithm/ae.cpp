@@ -1,51 +1,9 @@
 #include "ae.h"
+#include "island_model.h"
+#include "operator_policies.h"
 
 using namespace std;
 
-int load_tsp_coordinates(const string& file_path, vector<City>& cities) {
-    ifstream file(file_path);
-    if (!file) {
-        cerr << "Unable to load the file " << file_path << "\n";
-        exit(1);
-    }
-
-    string line;
-    int dimension = 0;
-
-    // Read the dimension and coordinates
-    while (getline(file, line)) {
-        if (line.find("DIMENSION") != string::npos) {
-            istringstream iss(line);
-            string temp;
-            while (iss >> temp) {
-                if (isdigit(temp[0])) {
-                    dimension = stoi(temp);
-                    break;
-                }
-            }
-        }
-        if (line == "NODE_COORD_SECTION") {
-            break;
-        }
-    }
-
-    cities.resize(dimension);
-
-    int id;
-    double x, y;
-    for (int i = 0; i < dimension; ++i) {
-        file >> id >> x >> y;
-        cities[id - 1] = {x, y}; // Make sure the IDs start from 1
-    }
-
-    file.close();
-    return dimension;
-}
-
-double euclidean_distance(const City& a, const City& b) {
-    return sqrt(pow(a.x - b.x, 2) + pow(a.y - b.y, 2));
-}
-
 // initialization of GA parameters and generation of the initial population
 Ae::Ae(int nbg, int tp, double cr, double mr, char* file_name, int v, int mds)
 {
@@ -55,20 +13,413 @@ Ae::Ae(int nbg, int tp, double cr, double mr, char* file_name, int v, int mds)
     mutation_rate = mr;
     verbose = v;
     max_duration_seconds = mds;
-    vector<City> cities;
+    memetic_rate = 0;
+    local_search_rate = 0;
+    local_search_moves = 0;
+    alias_batch = 0;
+    batch_size = 0;
+    pool = NULL;
+    islands = NULL;
+    island = 0;
+    report = true;
+    selection_operator = SELECTION_ROULETTE;
+    crossover_operator = CROSSOVER_2X;
+    mutation_operator = MUTATION_INVERT;
+    replacement_operator = REPLACEMENT_ROULETTE;
+    ranking_rate = 0;
+    restart_diversity = 0;
+    restart_elite = 0.1;
+    max_restarts = 3;
+    construction = Construction::RANDOM;
     chromosome_size = load_tsp_coordinates(file_name, cities);
     construct_distance_matrix(chromosome_size, cities);
     pop = new Population(population_size, chromosome_size);
+    workspaces.push_back(new_workspace());
+}
+
+// initialization of an algorithm sharing the parameters and the distance matrix of 'model'
+Ae::Ae(const Ae& model, int v)
+{
+    num_generations = model.num_generations;
+    population_size = model.population_size;
+    crossover_rate = model.crossover_rate;
+    mutation_rate = model.mutation_rate;
+    verbose = v;
+    max_duration_seconds = model.max_duration_seconds;
+    memetic_rate = model.memetic_rate;
+    local_search_rate = model.local_search_rate;
+    local_search_moves = model.local_search_moves;
+    alias_batch = model.alias_batch;
+    batch_size = 0;          // the island model gives each island the batches of the model
+    pool = NULL;
+    islands = NULL;
+    island = 0;
+    report = model.report;
+    selection_operator = model.selection_operator;
+    crossover_operator = model.crossover_operator;
+    mutation_operator = model.mutation_operator;
+    replacement_operator = model.replacement_operator;
+    ranking_rate = model.ranking_rate;
+    restart_diversity = model.restart_diversity;
+    restart_elite = model.restart_elite;
+    max_restarts = model.max_restarts;
+    neighbors = model.neighbors;
+    chromosome_size = model.chromosome_size;
+    distances = model.distances;
+    pop = new Population(population_size, chromosome_size);
+    pop->reject_duplicates = model.pop->reject_duplicates;
+    if (model.pop->edges)
+        pop->track_edges();
+    cities = model.cities;
+    construction = model.construction;
+    seed_population();
+    workspaces.push_back(new_workspace());
 }
 
 // destructor of the Ae object
 Ae::~Ae()
 {
     delete pop;
+    delete pool;
+    for (size_t w = 0; w < workspaces.size(); w++)
+    {
+        delete workspaces[w]->lin_kernighan;
+        delete workspaces[w]->eax;
+        delete workspaces[w]->local_search;
+        delete workspaces[w]->crossover_bandit;
+        delete workspaces[w]->mutation_bandit;
+        delete workspaces[w];
+    }
+    for (size_t k = 0; k < batch_children.size(); k++)
+        delete batch_children[k];
 }
 
-// main search procedure
+// scratch of a worker
+Workspace* Ae::new_workspace()
+{
+    Workspace* ws = new Workspace;
+    ws->in_segment1.assign(chromosome_size, 0);
+    ws->in_segment2.assign(chromosome_size, 0);
+    ws->mapping1.assign(chromosome_size, -1);
+    ws->mapping2.assign(chromosome_size, -1);
+    ws->lin_kernighan = (memetic_rate > 0) ? new LinKernighan<int>(distances, chromosome_size) : NULL;
+    ws->eax = (crossover_operator == CROSSOVER_EAX || crossover_operator == CROSSOVER_ADAPTIVE)
+            ? new EdgeAssembly(chromosome_size, distances, &neighbors, 10) : NULL;
+    ws->local_search = (local_search_rate > 0)
+            ? new LocalSearch(chromosome_size, distances, &neighbors, local_search_moves) : NULL;
+    ws->local_search_seconds = 0;
+    ws->crossover_bandit = (crossover_operator == CROSSOVER_ADAPTIVE)
+            ? new OperatorBandit(CROSSOVER_ADAPTIVE) : NULL;
+    ws->mutation_bandit = (mutation_operator == MUTATION_ADAPTIVE)
+            ? new OperatorBandit(MUTATION_ADAPTIVE) : NULL;
+    ws->crossover_arm = 0;
+    ws->crossover_start = 0;
+    return ws;
+}
+
+// selects the construction heuristic of the first individual by name
+bool Ae::set_construction(const string& name)
+{
+    if (!Construction::parse(name, construction))
+        return false;
+    seed_population();
+    return true;
+}
+
+// the other individuals stay random, so that the population is diverse;
+//   the nearest neighbour tour starts from a random city
+void Ae::seed_population()
+{
+    if (construction == Construction::RANDOM)
+        return;
+    Chromosome* first = pop->individuals[0];
+    Construction::build(construction, cities, distances, first->genes, Random::random(chromosome_size));
+    first->sort();
+}
+
+// 10 nearest cities of each city, computed once
+void Ae::build_neighbors()
+{
+    if (!neighbors.empty())
+        return;
+    int num_neighbors = min(10, chromosome_size - 1);
+    vector<int> others;
+    neighbors.resize(chromosome_size);
+    for (int c = 0; c < chromosome_size; c++)
+    {
+        others.clear();
+        for (int o = 0; o < chromosome_size; o++)
+            if (o != c)
+                others.push_back(o);
+        int *row = distances[c];
+        partial_sort(others.begin(), others.begin() + num_neighbors, others.end(),
+                     [row](int x, int y) { return row[x] < row[y] || (row[x] == row[y] && x < y); });
+        neighbors[c].assign(others.begin(), others.begin() + num_neighbors);
+    }
+}
+
+// selects the crossover operator by name; EAX needs the 10 nearest cities of each city,
+//   the adaptive crossover draws among the five others (EAX included)
+bool Ae::set_crossover_operator(const string& name)
+{
+    if (name == "1x")
+        crossover_operator = CROSSOVER_1X;
+    else if (name == "2x")
+        crossover_operator = CROSSOVER_2X;
+    else if (name == "2lox")
+        crossover_operator = CROSSOVER_2LOX;
+    else if (name == "pmx")
+        crossover_operator = CROSSOVER_PMX;
+    else if (name == "eax")
+        crossover_operator = CROSSOVER_EAX;
+    else if (name == "adaptive")
+        crossover_operator = CROSSOVER_ADAPTIVE;
+    else
+        return false;
+
+    bool eax = (crossover_operator == CROSSOVER_EAX || crossover_operator == CROSSOVER_ADAPTIVE);
+    if (eax)
+        build_neighbors();
+    for (size_t w = 0; w < workspaces.size(); w++)
+    {
+        if (eax && !workspaces[w]->eax)
+            workspaces[w]->eax = new EdgeAssembly(chromosome_size, distances, &neighbors, 10);
+        if (crossover_operator == CROSSOVER_ADAPTIVE && !workspaces[w]->crossover_bandit)
+            workspaces[w]->crossover_bandit = new OperatorBandit(CROSSOVER_ADAPTIVE);
+    }
+    return true;
+}
+
+// selects the selection operator by name
+bool Ae::set_selection_operator(const string& name)
+{
+    if (name == "roulette")
+        selection_operator = SELECTION_ROULETTE;
+    else if (name == "random")
+        selection_operator = SELECTION_RANDOM;
+    else if (name == "ranking")
+        selection_operator = SELECTION_RANKING;
+    else
+        return false;
+    return true;
+}
+
+// selects the mutation operator by name
+bool Ae::set_mutation_operator(const string& name)
+{
+    if (name == "swap")
+        mutation_operator = MUTATION_SWAP;
+    else if (name == "random-swap")
+        mutation_operator = MUTATION_RANDOM_SWAP;
+    else if (name == "move")
+        mutation_operator = MUTATION_MOVE;
+    else if (name == "invert")
+        mutation_operator = MUTATION_INVERT;
+    else if (name == "adaptive")
+        mutation_operator = MUTATION_ADAPTIVE;
+    else
+        return false;
+
+    for (size_t w = 0; w < workspaces.size(); w++)
+        if (mutation_operator == MUTATION_ADAPTIVE && !workspaces[w]->mutation_bandit)
+            workspaces[w]->mutation_bandit = new OperatorBandit(MUTATION_ADAPTIVE);
+    return true;
+}
+
+// selects the replacement operator by name
+bool Ae::set_replacement_operator(const string& name)
+{
+    if (name == "roulette")
+        replacement_operator = REPLACEMENT_ROULETTE;
+    else if (name == "random")
+        replacement_operator = REPLACEMENT_RANDOM;
+    else if (name == "ranking")
+        replacement_operator = REPLACEMENT_RANKING;
+    else
+        return false;
+    return true;
+}
+
+// enables the memetic step: each child is improved by Lin-Kernighan
+//   with probability 'rate' before being inserted in the population
+void Ae::enable_memetic(double rate)
+{
+    memetic_rate = rate;
+    for (size_t w = 0; w < workspaces.size(); w++)
+        if (!workspaces[w]->lin_kernighan)
+            workspaces[w]->lin_kernighan = new LinKernighan<int>(distances, chromosome_size);
+}
+
+// enables the 2-opt/Or-opt step: each child is improved with probability 'rate',
+//   by at most 'max_moves' moves, before being inserted in the population
+void Ae::enable_local_search(double rate, int max_moves)
+{
+    local_search_rate = rate;
+    local_search_moves = max(0, max_moves);
+    build_neighbors();
+    for (size_t w = 0; w < workspaces.size(); w++)
+        if (!workspaces[w]->local_search)
+            workspaces[w]->local_search = new LocalSearch(chromosome_size, distances, &neighbors, local_search_moves);
+}
+
+// partial restarts: when the diversity of the population falls below 'diversity',
+//   the best 'elite' fraction of the individuals is kept and the others are drawn
+//   again; the search stops after 'max_restarts' restarts in a row without improvement
+void Ae::set_restart(double diversity, double elite, int max_restarts)
+{
+    restart_diversity = diversity;
+    restart_elite = elite;
+    this->max_restarts = max(1, max_restarts);
+    if (restart_diversity > 0)
+        pop->track_edges();
+}
+
+// batched mode: each step selects the parents of 'batch' children, breeds them
+//   in parallel on 'num_threads' workers, then inserts them in one merge step
+void Ae::set_batch(int batch, int num_threads, unsigned first_stream)
+{
+    batch_size = (batch > 0) ? batch + batch % 2 : 0; // children are bred in pairs
+    delete pool;
+    pool = (batch_size > 0) ? new WorkerPool(num_threads, first_stream) : NULL;
+    int num_workers = pool ? pool->size : 1;
+    while ((int)workspaces.size() < num_workers)
+        workspaces.push_back(new_workspace());
+    batch_parents.assign(batch_size, NULL);
+    while ((int)batch_children.size() < batch_size)
+        batch_children.push_back(new Chromosome(chromosome_size));
+}
+
+// freezes the roulette selection weights in the alias table for 'batch'
+//   generations: the parents are then drawn in O(1)
+void Ae::set_alias_batch(int batch)
+{
+    alias_batch = max(0, batch);
+}
+
+// breeds two children from two parents with the scratch 'ws'
+template<class Crossover, class Mutation>
+void Ae::breed(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2, Workspace& ws)
+{
+    // perform crossover with probability "crossover_rate"
+    if(Random::uniform() < crossover_rate)
+    {
+        Crossover::cross(*this, parent1, parent2, child1, child2, ws);
+        // evaluate the two newly generated individuals
+        child1->evaluate(distances);
+        child2->evaluate(distances);
+        Crossover::credit(parent1, parent2, child1, child2, ws);
+    }
+    else
+    {
+        // the children keep the fitness and the hash of their parent
+        child1->copy(parent1);
+        child2->copy(parent2);
+    }
+
+    // perform mutation on one child with probability "mutation_rate"
+    //   (the fitness is updated by the variation of the changed edges)
+    if(Random::uniform() < mutation_rate)
+        Mutation::mutate(*this, child1, ws);
+
+    // perform mutation on the other child with probability "mutation_rate"
+    if(Random::uniform() < mutation_rate)
+        Mutation::mutate(*this, child2, ws);
+
+    // local search: improve each child with probability "local_search_rate"
+    if (ws.local_search)
+    {
+        Chromosome* children[2] = { child1, child2 };
+        for (int k = 0; k < 2; k++)
+            if (Random::uniform() < local_search_rate)
+            {
+                auto start = chrono::steady_clock::now();
+                if (ws.local_search->improve(children[k]) > 0)
+                    children[k]->evaluate(distances);
+                ws.local_search_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            }
+    }
+
+    // memetic step: improve each child with probability "memetic_rate"
+    if (ws.lin_kernighan)
+    {
+        if (Random::uniform() < memetic_rate)
+        {
+            if (ws.lin_kernighan->optimize(child1->genes) > 0)
+                child1->evaluate(distances);
+        }
+        if (Random::uniform() < memetic_rate)
+        {
+            if (ws.lin_kernighan->optimize(child2->genes) > 0)
+                child2->evaluate(distances);
+        }
+    }
+}
+
+// main search procedure: runs the main loop instantiated for the selected operators
 Chromosome* Ae::optimize()
+{
+    return (this->*strategy())();
+}
+
+// the instantiations of evolve() are chosen one operator at a time:
+//   each function below fixes one more policy from the selected operators
+template<class Selection, class Crossover, class Mutation>
+static Ae::Strategy replacement_strategy(ReplacementType replacement)
+{
+    switch (replacement)
+    {
+    case REPLACEMENT_RANDOM:  return &Ae::evolve<Selection, Crossover, Mutation, RandomReplacement>;
+    case REPLACEMENT_RANKING: return &Ae::evolve<Selection, Crossover, Mutation, RankingReplacement>;
+    default:                  return &Ae::evolve<Selection, Crossover, Mutation, RouletteReplacement>;
+    }
+}
+
+template<class Selection, class Crossover>
+static Ae::Strategy mutation_strategy(MutationType mutation, ReplacementType replacement)
+{
+    switch (mutation)
+    {
+    case MUTATION_SWAP:        return replacement_strategy<Selection, Crossover, SwapConsecutiveMutation>(replacement);
+    case MUTATION_RANDOM_SWAP: return replacement_strategy<Selection, Crossover, SwapRandomMutation>(replacement);
+    case MUTATION_MOVE:        return replacement_strategy<Selection, Crossover, MoveMutation>(replacement);
+    case MUTATION_ADAPTIVE:    return replacement_strategy<Selection, Crossover, AdaptiveMutation>(replacement);
+    default:                   return replacement_strategy<Selection, Crossover, InversionMutation>(replacement);
+    }
+}
+
+template<class Selection>
+static Ae::Strategy crossover_strategy(CrossoverType crossover, MutationType mutation, ReplacementType replacement)
+{
+    switch (crossover)
+    {
+    case CROSSOVER_1X:   return mutation_strategy<Selection, OnePointCrossover>(mutation, replacement);
+    case CROSSOVER_2LOX: return mutation_strategy<Selection, TwoPointLinearOrderCrossover>(mutation, replacement);
+    case CROSSOVER_PMX:  return mutation_strategy<Selection, PartiallyMappedCrossover>(mutation, replacement);
+    case CROSSOVER_EAX:  return mutation_strategy<Selection, EdgeAssemblyCrossover>(mutation, replacement);
+    case CROSSOVER_ADAPTIVE: return mutation_strategy<Selection, AdaptiveCrossover>(mutation, replacement);
+    default:             return mutation_strategy<Selection, TwoPointCrossover>(mutation, replacement);
+    }
+}
+
+// the roulette selection draws from the alias table if its weights are frozen
+Ae::Strategy Ae::strategy()
+{
+    switch (selection_operator)
+    {
+    case SELECTION_RANDOM:
+        return crossover_strategy<RandomSelection>(crossover_operator, mutation_operator, replacement_operator);
+    case SELECTION_RANKING:
+        return crossover_strategy<RankingSelection>(crossover_operator, mutation_operator, replacement_operator);
+    default:
+        if (alias_batch > 0)
+            return crossover_strategy<AliasSelection>(crossover_operator, mutation_operator, replacement_operator);
+        return crossover_strategy<RouletteSelection>(crossover_operator, mutation_operator, replacement_operator);
+    }
+}
+
+// main loop of the search
+template<class Selection, class Crossover, class Mutation, class Replacement>
+Chromosome* Ae::evolve()
 {
     int improvement = 0;
     Chromosome *child1 = new Chromosome(chromosome_size);
@@ -76,7 +427,12 @@ Chromosome* Ae::optimize()
     Chromosome *parent1;
     Chromosome *parent2;
     int best_fitness;
-    float ranking_rate = 0;
+    long long num_children = 0;
+    int num_restarts = 0;       // partial restarts of a converged population
+    int stale_restarts = 0;     // last restarts after which the best fitness did not improve
+    int restart_best;           // best fitness at the last restart
+    int last_restart = 0;       // generation of the last restart
+    next_freeze = 0;
 
     // evaluation of the individuals in the initial population
     for(int ind = 0; ind < population_size; ind++)
@@ -85,15 +441,21 @@ Chromosome* Ae::optimize()
     // sort the individuals based on their fitness
     pop->sort();
 
-    best_fitness = pop->individuals[pop->order[0]]->fitness;
+    best_fitness = pop->fitness[pop->order[0]];
+    restart_best = best_fitness;
     
     // display initial population statistics
-    cout << "Some statistics on the initial population" << endl;
-    pop->statistics();
-    cout << "\n\n";
+    if (report)
+    {
+        cout << "Some statistics on the initial population" << endl;
+        pop->statistics();
+        cout << "\n\n";
+    }
+    int next_migration = islands ? islands->migration_interval : num_generations;
 
     // Timer start for max duration
     auto start_time = chrono::high_resolution_clock::now();
+    uint64_t start_cycles = OperatorBandit::now();
 
     // while the limit on the number of generations is not reached
     for(int g = 0; g < num_generations; g++)
@@ -103,82 +465,163 @@ Chromosome* Ae::optimize()
             auto current_time = std::chrono::high_resolution_clock::now();
             auto elapsed_time = std::chrono::duration_cast<std::chrono::seconds>(current_time - start_time).count();
             if (elapsed_time > max_duration_seconds) {
-                cout << "Max duration reached. Stopping optimization." << endl;
+                if (report)
+                    cout << "Max duration reached. Stopping optimization." << endl;
                 break;
             }
         }
 
-        // select two individuals from the current population
-        parent1 = pop->roulette_selection();
-        parent2 = pop->roulette_selection();
-        //parent1 = pop->random_selection();
-        //parent2 = pop->random_selection();
-        //parent1 = pop->ranking_selection(ranking_rate); 
-        //parent2 = pop->ranking_selection(ranking_rate);
-
-        // perform crossover with probability "crossover_rate"
-        if(Random::random(1000) / 1000.0 < crossover_rate)
+        if (batch_size > 0)
         {
-            //crossover1X(parent1, parent2, child1, child2);    
-            crossover2X(parent1, parent2, child1, child2);
-            //crossover2LOX(parent1, parent2, child1, child2);
-            //crossoverPMX(parent1, parent2, child1, child2);
+            // select the parents of the whole batch from the current population
+            for (int k = 0; k < batch_size; k++)
+                batch_parents[k] = Selection::select(*this, g);
+
+            // breed the children in parallel: worker w breeds the pairs w, w + size, ...
+            pool->run([this](int worker) {
+                for (int k = 2 * worker; k < batch_size; k += 2 * pool->size)
+                    breed<Crossover, Mutation>(batch_parents[k], batch_parents[k + 1], batch_children[k], batch_children[k + 1], *workspaces[worker]);
+            });
+
+            // insert the new individuals into the population
+            for (int k = 0; k < batch_size; k++)
+                Replacement::insert(*this, batch_children[k]);
+            // a generation breeds two children
+            g += batch_size / 2 - 1;
         }
         else
         {
-            child1->copy(parent1);
-            child2->copy(parent2);
-        }
-
-        // perform mutation on one child with probability "mutation_rate"
-        if(Random::random(1000) / 1000.0 < mutation_rate)
-            //child1->swap_2_consecutive_genes();
-            //child1->swap_2_random_genes();
-            //child1->move_1_gene();
-            child1->invert_sequence_of_genes();
+            // select two individuals from the current population
+            parent1 = Selection::select(*this, g);
+            parent2 = Selection::select(*this, g);
 
-        // perform mutation on the other child with probability "mutation_rate"
-        if(Random::random(1000) / 1000.0 < mutation_rate)
-            //child2->swap_2_consecutive_genes();
-            //child2->swap_2_random_genes();
-            //child2->move_1_gene();
-            child2->invert_sequence_of_genes();
+            // crossover, evaluation, mutation and memetic step
+            breed<Crossover, Mutation>(parent1, parent2, child1, child2, *workspaces[0]);
 
-        // evaluate the two newly generated individuals
-        child1->evaluate(distances);
-        child2->evaluate(distances);
-
-        // insert the new individuals into the population
-        pop->roulette_replacement(child1);
-        pop->roulette_replacement(child2);
-        //pop->random_replacement(child1);
-        //pop->random_replacement(child2);
-        //pop->ranking_replacement(child1, ranking_rate);
-        //pop->ranking_replacement(child2, ranking_rate);
+            // insert the new individuals into the population
+            Replacement::insert(*this, child1);
+            Replacement::insert(*this, child2);
+        }
+        num_children += (batch_size > 0) ? batch_size : 2;
 
-        // re-sort the population based on fitness
-        pop->resort();
+        // exchange the best individuals with the other islands
+        if (islands && g + 1 >= next_migration)
+        {
+            islands->migrate(island);
+            next_migration += islands->migration_interval;
+        }
 
         // if one of the new solution-individuals is the best ever encountered
-        if (pop->individuals[pop->order[0]]->fitness < best_fitness)
+        if (pop->fitness[pop->order[0]] < best_fitness)
         {
-            best_fitness = pop->individuals[pop->order[0]]->fitness;
+            best_fitness = pop->fitness[pop->order[0]];
             if (verbose) {
                 cout << "Improvement of the best solution at generation " << g << " : " << best_fitness << endl;
             }
             improvement = g;
         }
+
+        // a converged population (low diversity, no improvement during population_size
+        //   generations, i.e. 2 * population_size children) is partially restarted, unless
+        //   the last restarts did not improve the best individual, or the budget left is
+        //   shorter than the number of generations a population has taken to converge on average
+        if (restart_diversity > 0 && g - max(improvement, last_restart) >= population_size
+            && pop->diversity() < restart_diversity)
+        {
+            stale_restarts = (best_fitness < restart_best) ? 0 : stale_restarts + 1;
+            double convergence = (double)(g + 1) / (num_restarts + 1);
+            double remaining = num_generations - (g + 1);
+            if (max_duration_seconds > 0)
+            {
+                double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start_time).count();
+                remaining = min(remaining, (max_duration_seconds - elapsed) * (g + 1) / max(elapsed, 1e-9));
+            }
+            if (stale_restarts >= max_restarts || remaining < convergence)
+            {
+                if (report)
+                    cout << "Population converged at generation " << g << " (diversity " << pop->diversity()
+                         << "), no improvement expected within the budget. Stopping optimization." << endl;
+                break;
+            }
+            pop->restart(max(1, (int)(restart_elite * population_size)), distances);
+            num_restarts++;
+            restart_best = best_fitness;
+            last_restart = g;
+            if (verbose)
+                cout << "Partial restart " << num_restarts << " at generation " << g << endl;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start_time).count();
+    uint64_t cycles = OperatorBandit::now() - start_cycles;
+    if (report)
+    {
+        cout << "Children bred per second: " << (long long)(num_children / max(seconds, 1e-9)) << endl;
+        if (restart_diversity > 0)
+            cout << "Partial restarts: " << num_restarts << endl;
+        if (local_search_rate > 0)
+        {
+            // the workers of a batch search in parallel: their time adds up
+            double local_search_seconds = 0;
+            for (size_t w = 0; w < workspaces.size(); w++)
+                local_search_seconds += workspaces[w]->local_search_seconds;
+            double worker_seconds = seconds * (pool ? pool->size : 1);
+            cout << "Time split: local search " << local_search_seconds << " s ("
+                 << 100 * local_search_seconds / max(worker_seconds, 1e-9) << " %), GA operators "
+                 << worker_seconds - local_search_seconds << " s" << endl;
+        }
+        if (crossover_operator == CROSSOVER_ADAPTIVE || mutation_operator == MUTATION_ADAPTIVE)
+            report_operator_mix(seconds, cycles);
+
+        // display final population statistics
+        cout << "Some statistics on the final population" << endl;
+        pop->statistics();
+        // display the consanguinity of the final population
+        pop->similarity();
     }
-    // display final population statistics
-    cout << "Some statistics on the final population" << endl;
-    pop->statistics();
-    // display the consanguinity of the final population
-    pop->similarity();
 
     // return the best individual encountered during the search
     return pop->individuals[pop->order[0]];
 }
 
+// share of the calls and of the time of each operator chosen by a bandit, summed over
+//   the workers, with its mean improvement per microsecond ('cycles' of the counter
+//   elapsed in 'seconds' convert its cycles to time)
+void Ae::report_operator_mix(double seconds, uint64_t cycles)
+{
+    static const char* crossover_names[] = { "1x", "2x", "2lox", "pmx", "eax" };
+    static const char* mutation_names[] = { "swap", "random-swap", "move", "invert" };
+    double ns_per_cycle = seconds * 1e9 / max(cycles, (uint64_t)1);
+    for (int kind = 0; kind < 2; kind++)
+    {
+        bool crossover = (kind == 0);
+        if (crossover ? crossover_operator != CROSSOVER_ADAPTIVE : mutation_operator != MUTATION_ADAPTIVE)
+            continue;
+        int num_operators = crossover ? (int)CROSSOVER_ADAPTIVE : (int)MUTATION_ADAPTIVE;
+        vector<long long> calls(num_operators, 0);
+        vector<double> spent(num_operators, 0), gain(num_operators, 0);
+        long long total_calls = 0;
+        double total_spent = 0;
+        for (size_t w = 0; w < workspaces.size(); w++)
+        {
+            OperatorBandit* bandit = crossover ? workspaces[w]->crossover_bandit : workspaces[w]->mutation_bandit;
+            for (int op = 0; op < num_operators; op++)
+            {
+                calls[op] += bandit->calls[op];
+                spent[op] += bandit->cycles[op] * ns_per_cycle;
+                gain[op] += bandit->improvement[op];
+                total_calls += bandit->calls[op];
+                total_spent += bandit->cycles[op] * ns_per_cycle;
+            }
+        }
+        cout << (crossover ? "Crossover mix" : "Mutation mix") << " (calls, time, improvement per microsecond):" << endl;
+        for (int op = 0; op < num_operators; op++)
+            cout << "   " << (crossover ? crossover_names[op] : mutation_names[op]) << ": "
+                 << 100.0 * calls[op] / max(total_calls, 1LL) << " %, "
+                 << 100.0 * spent[op] / max(total_spent, 1e-9) << " %, "
+                 << 1000.0 * gain[op] / max(spent[op], 1e-9) << endl;
+    }
+}
+
 // single point crossover operator: crossover1X
 // 1) the 1X operator randomly chooses a crossover point
 // 2) the 1X operator copies the beginning of parent 1 to the beginning of child 1
@@ -186,41 +629,16 @@ Chromosome* Ae::optimize()
 // 3) the 1X operator completes child 1 with the missing genes by placing them in the order of parent 2
 //                         and child 2 with the missing genes by placing them in the order of parent 1.
 void Ae::crossover1X(Chromosome* parent1, Chromosome* parent2,
-                     Chromosome* child1, Chromosome* child2)
+                     Chromosome* child1, Chromosome* child2, Workspace& ws)
 {
     int num_genes = parent1->size;
 
-    int* order_parent1 = new int[num_genes];
-    int* order_parent2 = new int[num_genes];
-
-    for (int i = 0; i < num_genes; i++)
-    {
-        order_parent1[parent1->genes[i]] = i;
-        order_parent2[parent2->genes[i]] = i;
-    }
-
     // 1) the 1X operator randomly chooses the crossover point
     int point = Random::random(num_genes);
 
-    // 2) the 1X operator copies the beginning of parent 1 to the beginning of child 1
-    //                     and the beginning of parent 2 to the beginning of child 2.
-    child1->copy(parent1);
-    child2->copy(parent2);
-
-    // 3) the 1X operator completes child 1 with the missing genes by placing them in the order of parent 2
-    //                         and child 2 with the missing genes by placing them in the order of parent 1.
-    for (int k = point + 1; k < num_genes; k++)
-    {
-        for (int l = k + 1; l < num_genes; l++)
-        {
-            if(order_parent2[child1->genes[k]] > order_parent2[child1->genes[l]])
-                child1->swap_2_genes(k, l);
-            if(order_parent1[child2->genes[k]] > order_parent1[child2->genes[l]])
-                child2->swap_2_genes(k, l);
-        }
-    }
-    delete[] order_parent1;
-    delete[] order_parent2;
+    // 2) and 3) the genes after the point are those of the parent, in the order of the other parent
+    reorder_segment(parent1, parent2, child1, point + 1, num_genes, ws.in_segment1);
+    reorder_segment(parent2, parent1, child2, point + 1, num_genes, ws.in_segment2);
 }
 
 // two-point crossover operator: crossover2X
@@ -230,19 +648,10 @@ void Ae::crossover1X(Chromosome* parent1, Chromosome* parent2,
 // 3) the 2X operator completes child 1 with the missing genes by placing them in the order of parent 2
 //                         and child 2 with the missing genes by placing them in the order of parent 1.
 void Ae::crossover2X(Chromosome* parent1, Chromosome* parent2,
-                     Chromosome* child1, Chromosome* child2)
+                     Chromosome* child1, Chromosome* child2, Workspace& ws)
 {
     int num_genes = parent1->size;
 
-    int* order_parent1 = new int[num_genes];
-    int* order_parent2 = new int[num_genes];
-
-    for (int i = 0; i < num_genes; i++)
-    {
-        order_parent1[parent1->genes[i]] = i;
-        order_parent2[parent2->genes[i]] = i;
-    }
-
     // 1) the 2X operator randomly chooses two crossover points
     int point1 = Random::random(num_genes);
     int point2 = Random::random(num_genes);
@@ -253,30 +662,43 @@ void Ae::crossover2X(Chromosome* parent1, Chromosome* parent2,
         std::swap(point1, point2);
     }
 
-    // 2) the 2X operator copies the beginning of parent 1 to the beginning of child 1
-    // and the beginning of parent 2 to the beginning of child 2.
-    child1->copy(parent1);
-    child2->copy(parent2);
+    // 2) and 3) the genes strictly between the points are those of the parent,
+    // in the order of the other parent
+    reorder_segment(parent1, parent2, child1, point1 + 1, point2, ws.in_segment1);
+    reorder_segment(parent2, parent1, child2, point1 + 1, point2, ws.in_segment2);
+}
 
-    // 3) complete child 1 with the missing genes by placing them in the order of parent 2
-    // and child 2 with the missing genes by placing them in the order of parent 1.
-    for (int k = point1 + 1; k < point2; k++)
+// copies 'parent' to 'child', then rewrites the genes of the positions begin..end-1
+//   in the order they have in 'other': the genes of the segment are marked in
+//   'in_segment', and 'other' is scanned once (O(n) instead of the exchange sort)
+void Ae::reorder_segment(Chromosome* parent, Chromosome* other, Chromosome* child,
+                         int begin, int end, vector<char>& in_segment)
+{
+    child->copy(parent);
+    if (end - begin < 2)
+        return;
+    for (int i = begin; i < end; i++)
+        in_segment[parent->genes[i]] = 1;
+    int position = begin;
+    for (int i = 0; i < other->size && position < end; i++)
     {
-        for (int l = k + 1; l < point2; l++)
+        int gene = other->genes[i];
+        if (in_segment[gene])
         {
-            if (order_parent2[child1->genes[k]] > order_parent2[child1->genes[l]])
-                child1->swap_2_genes(k, l);
-            if (order_parent1[child2->genes[k]] > order_parent1[child2->genes[l]])
-                child2->swap_2_genes(k, l);
+            child->genes[position++] = gene;
+            in_segment[gene] = 0;
         }
     }
-
-    delete[] order_parent1;
-    delete[] order_parent2;
 }
 
+// 2LOX crossover operator: crossover2LOX
+// 1) the 2LOX operator randomly chooses 2 crossover points
+// 2) the 2LOX operator copies the segment between the points of parent 1 to child 1
+//                                          and of parent 2 to child 2
+// 3) the 2LOX operator completes child 1 with the other genes in the order of parent 2,
+//    and child 2 in the order of parent 1, starting after the second point and wrapping around
 void Ae::crossover2LOX(Chromosome* parent1, Chromosome* parent2,
-                       Chromosome* child1, Chromosome* child2)
+                       Chromosome* child1, Chromosome* child2, Workspace& ws)
 {
     int num_genes = parent1->size;
 
@@ -289,53 +711,45 @@ void Ae::crossover2LOX(Chromosome* parent1, Chromosome* parent2,
         std::swap(point1, point2);
     }
 
-    // Step 2: Copy the segment between the crossover points from parent 1 to child 1
-    //                     and from parent 2 to child 2.
+    // Steps 2 and 3 for each child
+    fill_around_segment(parent1, parent2, child1, point1, point2, ws.in_segment1);
+    fill_around_segment(parent2, parent1, child2, point1, point2, ws.in_segment2);
+}
+
+// copies the genes of positions point1..point2 of 'parent' to 'child' and marks them,
+//   then writes the unmarked genes of 'other', read from point2 + 1 and wrapping around,
+//   to the positions of 'child' from point2 + 1 (wrapping around)
+void Ae::fill_around_segment(Chromosome* parent, Chromosome* other, Chromosome* child,
+                             int point1, int point2, vector<char>& in_segment)
+{
+    int num_genes = parent->size;
     for (int i = point1; i <= point2; i++) {
-        child1->genes[i] = parent1->genes[i];
-        child2->genes[i] = parent2->genes[i];
+        child->genes[i] = parent->genes[i];
+        in_segment[parent->genes[i]] = 1;
     }
 
-    // Step 3: Fill in the remaining genes in the same order they appear in the other parent,
-    //         starting after the second crossover point and wrapping around to the beginning.
-    int current_pos1 = (point2 + 1) % num_genes;
-    int current_pos2 = (point2 + 1) % num_genes;
-    for (int i = 0; i < num_genes; i++) {
-        int gene = parent2->genes[(point2 + 1 + i) % num_genes];
-        bool already_present = false;
-        for (int j = point1; j <= point2; j++) {
-            if (child1->genes[j] == gene) {
-                already_present = true;
-                break;
-            }
-        }
-        if (!already_present) {
-            child1->genes[current_pos1] = gene;
-            current_pos1 = (current_pos1 + 1) % num_genes;
+    int current_pos = (point2 + 1) % num_genes;
+    int i = (point2 + 1) % num_genes;
+    for (int k = 0; k < num_genes; k++) {
+        int gene = other->genes[i];
+        if (!in_segment[gene]) {
+            child->genes[current_pos] = gene;
+            current_pos = (current_pos + 1 == num_genes) ? 0 : current_pos + 1;
         }
+        i = (i + 1 == num_genes) ? 0 : i + 1;
     }
 
-    for (int i = 0; i < num_genes; i++) {
-        int gene = parent1->genes[(point2 + 1 + i) % num_genes];
-        bool already_present = false;
-        for (int j = point1; j <= point2; j++) {
-            if (child2->genes[j] == gene) {
-                already_present = true;
-                break;
-            }
-        }
-        if (!already_present) {
-            child2->genes[current_pos2] = gene;
-            current_pos2 = (current_pos2 + 1) % num_genes;
-        }
-    }
+    for (int i = point1; i <= point2; i++)
+        in_segment[parent->genes[i]] = 0;
 }
 
 // PMX crossover operator: crossoverPMX
 // 1) the PMX operator randomly chooses 2 crossover points
 // 2) the PMX operator swaps the genes between the crossover points
 // 3) the PMX operator resolves conflicts for the genes outside the crossover points
-void Ae::crossoverPMX(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2) {
+// The mapping is a bijection between the two segments, so its chains are disjoint:
+//   following them for all the conflicting genes costs O(n) in total
+void Ae::crossoverPMX(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2, Workspace& ws) {
     int num_genes = parent1->size;
 
     // Copy the parents to children
@@ -352,27 +766,26 @@ void Ae::crossoverPMX(Chromosome* parent1, Chromosome* parent2, Chromosome* chil
     }
 
     // Create mapping for genes between crossover points
-    unordered_map<int, int> mapping1, mapping2;
-
+    // (mapping1 and mapping2 are kept at -1 outside of a call)
     for (int i = point1; i <= point2; i++) {
         child1->genes[i] = parent2->genes[i];
         child2->genes[i] = parent1->genes[i];
-        mapping1[parent2->genes[i]] = parent1->genes[i];
-        mapping2[parent1->genes[i]] = parent2->genes[i];
+        ws.mapping1[parent2->genes[i]] = parent1->genes[i];
+        ws.mapping2[parent1->genes[i]] = parent2->genes[i];
     }
 
     // Resolve conflicts in child1
     for (int i = 0; i < point1; i++) {
         int gene = child1->genes[i];
-        while (mapping1.find(gene) != mapping1.end()) {
-            gene = mapping1[gene];
+        while (ws.mapping1[gene] >= 0) {
+            gene = ws.mapping1[gene];
         }
         child1->genes[i] = gene;
     }
     for (int i = point2 + 1; i < num_genes; i++) {
         int gene = child1->genes[i];
-        while (mapping1.find(gene) != mapping1.end()) {
-            gene = mapping1[gene];
+        while (ws.mapping1[gene] >= 0) {
+            gene = ws.mapping1[gene];
         }
         child1->genes[i] = gene;
     }
@@ -380,18 +793,36 @@ void Ae::crossoverPMX(Chromosome* parent1, Chromosome* parent2, Chromosome* chil
     // Resolve conflicts in child2
     for (int i = 0; i < point1; i++) {
         int gene = child2->genes[i];
-        while (mapping2.find(gene) != mapping2.end()) {
-            gene = mapping2[gene];
+        while (ws.mapping2[gene] >= 0) {
+            gene = ws.mapping2[gene];
         }
         child2->genes[i] = gene;
     }
     for (int i = point2 + 1; i < num_genes; i++) {
         int gene = child2->genes[i];
-        while (mapping2.find(gene) != mapping2.end()) {
-            gene = mapping2[gene];
+        while (ws.mapping2[gene] >= 0) {
+            gene = ws.mapping2[gene];
         }
         child2->genes[i] = gene;
     }
+
+    // Reset the mappings
+    for (int i = point1; i <= point2; i++) {
+        ws.mapping1[parent2->genes[i]] = -1;
+        ws.mapping2[parent1->genes[i]] = -1;
+    }
+}
+
+// Edge Assembly Crossover: crossoverEAX
+// each child is built from the edges of one parent, where an AB-cycle
+//   (edges alternately taken from each parent) replaces the edges of the first
+//   parent by those of the second; the subtours obtained are then merged
+//   (see EdgeAssembly). Child 1 starts from parent 1 and child 2 from parent 2.
+void Ae::crossoverEAX(Chromosome* parent1, Chromosome* parent2,
+                      Chromosome* child1, Chromosome* child2, Workspace& ws)
+{
+    ws.eax->cross(parent1, parent2, child1);
+    ws.eax->cross(parent2, parent1, child2);
 }
 
 void Ae::construct_distance_matrix(int dimension, vector<City>& cities) {
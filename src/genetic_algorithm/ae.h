@@ -9,19 +9,68 @@
 #include <algorithm>
 #include <vector>
 #include <chrono>
-#include <unordered_map>
 #include <unordered_set>
 #include "population.h"
 #include "chromosome.h"
+#include "worker_pool.h"
+#include "edge_assembly.h"
+#include "local_search.h"
+#include "operator_bandit.h"
+#include "../common/lin_kernighan.h"
+#include "../common/tsp_file.h"
+#include "../common/construction.h"
 
 using namespace std;
 
-/**
- * This structure defines a city with its coordinates.
- */
-struct City {
-    double x;
-    double y;
+class IslandModel;
+
+// Crossover operators of the genetic algorithm
+enum CrossoverType {
+    CROSSOVER_1X,
+    CROSSOVER_2X,
+    CROSSOVER_2LOX,
+    CROSSOVER_PMX,
+    CROSSOVER_EAX,
+    CROSSOVER_ADAPTIVE // one of the above, chosen by a bandit at each crossover
+};
+
+// Selection operators of the genetic algorithm
+enum SelectionType {
+    SELECTION_ROULETTE,
+    SELECTION_RANDOM,
+    SELECTION_RANKING
+};
+
+// Mutation operators of the genetic algorithm
+enum MutationType {
+    MUTATION_SWAP,        // interchange of 2 consecutive genes
+    MUTATION_RANDOM_SWAP, // interchange of 2 random genes
+    MUTATION_MOVE,        // move of 1 gene
+    MUTATION_INVERT,      // inversion of a sequence of genes
+    MUTATION_ADAPTIVE     // one of the above, chosen by a bandit at each mutation
+};
+
+// Replacement operators of the genetic algorithm
+enum ReplacementType {
+    REPLACEMENT_ROULETTE,
+    REPLACEMENT_RANDOM,
+    REPLACEMENT_RANKING
+};
+
+// Scratch of the operators: one per worker, so that workers breed children concurrently
+struct Workspace {
+    vector<char> in_segment1; // crossover scratch: genes of the segment of child 1, all 0 outside of a call
+    vector<char> in_segment2; // crossover scratch: genes of the segment of child 2, all 0 outside of a call
+    vector<int> mapping1;    // PMX scratch: gene of parent 1 mapped to each gene of parent 2, -1 if none
+    vector<int> mapping2;    // PMX scratch: gene of parent 2 mapped to each gene of parent 1, -1 if none
+    LinKernighan<int> *lin_kernighan; // local improvement of the children (memetic step), NULL if disabled
+    EdgeAssembly *eax;       // EAX scratch, NULL if another crossover is used
+    LocalSearch *local_search; // 2-opt/Or-opt improvement of the children, NULL if disabled
+    double local_search_seconds; // time spent by this worker in the local search
+    OperatorBandit *crossover_bandit; // adaptive crossover: credit of each operator, NULL otherwise
+    OperatorBandit *mutation_bandit;  // adaptive mutation: credit of each operator, NULL otherwise
+    int crossover_arm;       // adaptive crossover: operator of the crossover in progress
+    uint64_t crossover_start; // adaptive crossover: cycle counter at its start
 };
 
 // The Ae class defines the parameters for running an evolutionary algorithm
@@ -36,32 +85,105 @@ public:
     int chromosome_size;     // number of genes in the chromosome
     Population *pop;         // list of individuals in the population
     int **distances;         // distance matrix between cities
+    vector<City> cities;     // coordinates of the cities, used by the construction heuristics
+    Construction::Method construction; // heuristic building the first individual, RANDOM for none
     int verbose;             // verbose output
     int max_duration_seconds; // maximum duration in seconds
+    double memetic_rate;     // probability to improve a child with Lin-Kernighan: value between 0 and 1
+    double local_search_rate; // probability to improve a child with 2-opt/Or-opt: value between 0 and 1
+    int local_search_moves;  // number of 2-opt/Or-opt moves applied per child, 0 for no limit
+    int alias_batch;         // number of generations during which the selection weights are frozen
+                             // in the alias table, 0 to select from the up-to-date weights
+    int next_freeze;         // generation at which the selection weights are frozen again
+    vector<Workspace*> workspaces; // scratch of the workers, workspaces[0] for the calling thread
+    int batch_size;          // number of children bred in parallel per step, 0 for the steady-state GA
+    WorkerPool *pool;        // workers breeding the children of a batch, NULL if not batched
+    vector<Chromosome*> batch_parents;  // parents selected for the batch in progress
+    vector<Chromosome*> batch_children; // children of the batch in progress
+    IslandModel *islands;    // island model the population belongs to, NULL if alone
+    int island;              // index of the population in the island model
+    bool report;             // true to display the statistics of the population during the search
+    SelectionType selection_operator;     // selection of the parents, roulette by default
+    CrossoverType crossover_operator;     // crossover applied to the parents, 2X by default
+    MutationType mutation_operator;       // mutation applied to the children, inversion by default
+    ReplacementType replacement_operator; // replacement of an individual by a child, roulette by default
+    float ranking_rate;      // selection pressure of the ranking operators, 0 (strong) to +INFINITY (none)
+    double restart_diversity; // diversity below which the population is partially restarted, 0 to disable
+    double restart_elite;    // fraction of the best individuals kept by a restart
+    int max_restarts;        // restarts in a row without improvement before the search stops
+    vector<vector<int> > neighbors;   // nearest cities of each city (EAX), empty otherwise
 
     // CONSTRUCTORS
     Ae(int ng, int ps, double cr, double mr, char* file_name, int v, int mds);
                              // constructor of the Evolutionary Algorithm object
+    Ae(const Ae& model, int v);
+                             // constructor of an algorithm with the parameters and the distances of
+                             // 'model', and its own initial population (islands)
     ~Ae();                   // destructor of the Ae object
 
     // METHODS
     void construct_distance_matrix(int dimension, vector<City>& cities);
                              // constructs the distance matrix
     Chromosome* optimize();  // main function that directs the evolutionary algorithm
+    typedef Chromosome* (Ae::*Strategy)();
+    Strategy strategy();     // instantiation of evolve() for the selected operators
+    template<class Selection, class Crossover, class Mutation, class Replacement>
+    Chromosome* evolve();    // main loop of the search with the given operator policies
+    void enable_memetic(double rate);
+                             // improves each child with Lin-Kernighan with probability 'rate'
+    void enable_local_search(double rate, int max_moves);
+                             // improves each child with at most 'max_moves' 2-opt/Or-opt moves
+                             // with probability 'rate'
+    void build_neighbors();  // nearest cities of each city, for EAX and the local search
+    void set_alias_batch(int batch);
+                             // freezes the selection weights for 'batch' generations (0 to disable)
+    void set_restart(double diversity, double elite, int max_restarts);
+                             // restarts the population when its diversity falls below 'diversity',
+                             // keeping the 'elite' fraction of the best individuals
+    void set_batch(int batch, int num_threads, unsigned first_stream = 0);
+                             // breeds 'batch' children per step on 'num_threads' workers (batch 0 to disable),
+                             // worker k drawing from the random stream first_stream + k
+    bool set_construction(const string& name);
+                             // builds the first individual with a construction heuristic among
+                             // random, nn, greedy, sfc and savings, false if unknown
+    void seed_population();  // replaces the first individual by the tour of the construction heuristic
+    bool set_selection_operator(const string& name);
+                             // selects the selection among roulette, random and ranking, false if unknown
+    bool set_crossover_operator(const string& name);
+                             // selects the crossover among 1x, 2x, 2lox, pmx, eax and adaptive, false if unknown
+    bool set_mutation_operator(const string& name);
+                             // selects the mutation among swap, random-swap, move, invert and adaptive, false if unknown
+    bool set_replacement_operator(const string& name);
+                             // selects the replacement among roulette, random and ranking, false if unknown
+    Workspace* new_workspace(); // scratch of a worker, with its own Lin-Kernighan if memetic
+    void report_operator_mix(double seconds, uint64_t cycles);
+                             // displays the share of the calls and the time of each adaptive operator
+    template<class Crossover, class Mutation>
+    void breed(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2, Workspace& ws);
+                             // crossover, evaluation, mutation and memetic step of two children
 
     // CROSSOVER OPERATORS
     // 1X crossover operator for two chromosomes
     void crossover1X(Chromosome* parent1, Chromosome* parent2,
-                     Chromosome* child1, Chromosome* child2);
+                     Chromosome* child1, Chromosome* child2, Workspace& ws);
     // 2X crossover operator for two chromosomes
     void crossover2X(Chromosome* parent1, Chromosome* parent2,
-                     Chromosome* child1, Chromosome* child2);
+                     Chromosome* child1, Chromosome* child2, Workspace& ws);
     // 2LOX crossover operator for two chromosomes
     void crossover2LOX(Chromosome* parent1, Chromosome* parent2,
-                       Chromosome* child1, Chromosome* child2);
+                       Chromosome* child1, Chromosome* child2, Workspace& ws);
+    // reorders the positions begin..end-1 of a copy of 'parent' as in 'other' (1X, 2X)
+    void reorder_segment(Chromosome* parent, Chromosome* other, Chromosome* child,
+                         int begin, int end, vector<char>& in_segment);
+    // copies a segment of 'parent' and completes it in the order of 'other' (2LOX)
+    void fill_around_segment(Chromosome* parent, Chromosome* other, Chromosome* child,
+                             int point1, int point2, vector<char>& in_segment);
     // PMX crossover operator for two chromosomes
     void crossoverPMX(Chromosome* parent1, Chromosome* parent2,
-                      Chromosome* child1, Chromosome* child2);
+                      Chromosome* child1, Chromosome* child2, Workspace& ws);
+    // Edge Assembly Crossover (EAX) for two chromosomes
+    void crossoverEAX(Chromosome* parent1, Chromosome* parent2,
+                      Chromosome* child1, Chromosome* child2, Workspace& ws);
 };
 
 # endif
@@ -0,0 +1,62 @@
+#include "alias_table.h"
+
+// initialization of a table of n indices
+AliasTable::AliasTable(int n)
+{
+    size = n;
+    prob = new double[size];
+    alias = new int[size];
+    small = new int[size];
+    large = new int[size];
+    for (int i = 0; i < size; i++)
+    {
+        prob[i] = 1;
+        alias[i] = i;
+    }
+}
+
+// destruction of the "AliasTable" object
+AliasTable::~AliasTable()
+{
+    delete[] prob;
+    delete[] alias;
+    delete[] small;
+    delete[] large;
+}
+
+// Vose's method: the weights are scaled so that their mean is 1, then each
+//   cell of a light index is filled up by a heavy index, which loses as much weight
+void AliasTable::build(const double *weights)
+{
+    double sum = 0;
+    for (int i = 0; i < size; i++)
+        sum += weights[i];
+
+    int num_small = 0, num_large = 0;
+    for (int i = 0; i < size; i++)
+    {
+        prob[i] = weights[i] * size / sum;
+        alias[i] = i;
+        if (prob[i] < 1)
+            small[num_small++] = i;
+        else
+            large[num_large++] = i;
+    }
+    while (num_small > 0 && num_large > 0)
+    {
+        int light = small[--num_small];
+        int heavy = large[num_large - 1];
+        alias[light] = heavy;
+        prob[heavy] -= 1 - prob[light];
+        if (prob[heavy] < 1)
+        {
+            num_large--;
+            small[num_small++] = heavy;
+        }
+    }
+    // the remaining cells are full (up to rounding errors)
+    while (num_large > 0)
+        prob[large[--num_large]] = 1;
+    while (num_small > 0)
+        prob[small[--num_small]] = 1;
+}
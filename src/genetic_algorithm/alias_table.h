@@ -0,0 +1,31 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include "../common/random.h"
+
+// The AliasTable class draws an index with fixed weights in O(1) (Vose's alias method):
+//   each of the n cells holds an index with probability prob[i], and its alias otherwise.
+//   Building the table costs O(n), so it suits a batch of draws with frozen weights.
+class AliasTable {
+public:
+    // ATTRIBUTES
+    int size;          // number of indices
+    double *prob;      // probability to keep the index of the cell
+    int *alias;        // index drawn when the cell is not kept
+    int *small;        // build scratch: cells whose scaled weight is below 1
+    int *large;        // build scratch: cells whose scaled weight is at least 1
+
+    // CONSTRUCTORS
+    AliasTable(int n); // constructor of the object
+    ~AliasTable();     // destructor of the object
+
+    // METHODS
+    void build(const double *weights); // builds the table for the given weights (not all null)
+    int sample()                       // draws an index
+    {
+        int i = Random::random(size);
+        return Random::uniform() < prob[i] ? i : alias[i];
+    }
+};
+
+# endif
@@ -1,35 +1,37 @@
+#include <algorithm>
+#include <string.h>
 #include "chromosome.h"
+#include "../common/construction.h"
 
 using namespace std;
 
 // initialization of the parameters of a chromosome
 Chromosome::Chromosome(int cs)
 {
-    int a;
-    bool retry = true;
     size = cs;
     // a chromosome is composed of 'size' genes,
     // genes are characterized by an integer between 0 and 'size-1'
-    // it cannot have the same gene twice in a chromosome
     genes = new int[size];
+    owns_genes = true;
+    hash = 0;
+    random_genes();
+}
+
+// initialization of a chromosome whose genes are stored by a population
+Chromosome::Chromosome(int cs, int *storage)
+{
+    size = cs;
+    genes = storage;
+    owns_genes = false;
+    hash = 0;
+    random_genes();
+}
+
+// random chromosome (Fisher-Yates shuffle): it cannot have the same gene twice in a chromosome
+void Chromosome::random_genes()
+{
     // Arbitrarily, we choose to always start a chromosome with gene 0
-    genes[0] = 0;
-    for(int i = 1; i < size; i++)
-    {
-        retry = true;
-        while(retry)
-        {
-            retry = false;
-            // randomly pick the next gene
-            a = Random::random(size);
-            // the gene must not already be in the chromosome
-            // if it is, we randomly pick the gene again
-            for (int j = 0; j < i; j++)
-                if (a == genes[j])
-                    retry = true;
-        }
-        genes[i] = a;
-    }
+    Construction::random_tour(genes, size);
     // we arbitrarily impose that gene[1] > gene[size-1]
     sort();
 }
@@ -37,66 +39,53 @@ Chromosome::Chromosome(int cs)
 // destruction of the 'Chromosome' object
 Chromosome::~Chromosome()
 {
-    delete[] genes;
+    if (owns_genes)
+        delete[] genes;
 }
 
 // we arbitrarily impose that the 2nd visited city (gene[1])
 //   has a number smaller than the last visited city (gene[size-1])
 //   i.e. : gene[1] > gene[size-1]
+// the genes are rotated and reversed in place. The orientation is only needed
+//   to compare or display chromosomes, the operators work on any rotation
 void Chromosome::sort()
 {
-    int temp, k;
     // Place city "0" at the head of the chromosome (genes[0])
     if (genes[0] != 0)
-    {
-        int position_0 = 0;
-        int * genes_c = new int[size];
-        for (int i = 0; i < size; i++)
-        {
-            genes_c[i] = genes[i];
-            if (genes[i] == 0)
-                position_0 = i;
-        }
-        k = 0;
-        for (int i = position_0; i < size; i++)
-        {
-            genes[k] = genes_c[i];
-            k++;
-        }
-        for (int i = 0; i < position_0; i++)
-        {
-            genes[k] = genes_c[i];
-            k++;
-        }
-        delete[] genes_c;
-    }
+        std::rotate(genes, std::find(genes, genes + size, 0), genes + size);
 
     // The number of the 2nd city must be smaller than that of the last city
     if (genes[1] > genes[size - 1])
-    {
-        for(int k = 1; k <= 1 + (size - 2) / 2; k++)
-        {
-            temp = genes[k];
-            genes[k] = genes[size - k];
-            genes[size - k] = temp;
-        }
-    }
+        std::reverse(genes + 1, genes + size);
 }
 
-// evaluation of a solution: function that calculates the fitness of a solution
+// evaluation of a solution: function that calculates the fitness of a solution,
+//   and its hash in the same pass over the edges
 void Chromosome::evaluate(int **distance)
 {
-    fitness = 0;
+    fitness = distance[genes[0]][genes[size - 1]];
+    hash = TourHash::edge_key(genes[0], genes[size - 1]);
     for(int i = 0; i < size - 1; i++)
+    {
         fitness += distance[genes[i]][genes[i + 1]];
-    fitness += distance[genes[0]][genes[size - 1]];
+        hash ^= TourHash::edge_key(genes[i], genes[i + 1]);
+    }
 }
 
-// copies the genes of a chromosome. fitness is not copied
+// copies the genes of a chromosome, its fitness and its hash
 void Chromosome::copy(Chromosome* source)
 {
-    for(int i = 0; i < size; i++)
-        genes[i] = source->genes[i];
+    memcpy(genes, source->genes, size * sizeof(int));
+    fitness = source->fitness;
+    hash = source->hash;
+}
+
+// the hash is the XOR of the keys of the edges: adding or removing an edge
+//   toggles its key
+void Chromosome::change_edge(int **distance, int a, int b, int sign)
+{
+    fitness += sign * distance[a][b];
+    hash ^= TourHash::edge_key(a, b);
 }
 
 // swaps 2 genes
@@ -107,31 +96,47 @@ void Chromosome::swap_2_genes(int gene1, int gene2)
     genes[gene2] = temp;
 }
 
-void Chromosome::swap_2_consecutive_genes()
+int Chromosome::swap_2_consecutive_genes(int **distance)
 {
     // randomly select a gene between the first and the second to last.
     // Reminder: Random::random(size - 1) returns a random integer between 0 and size - 2
     int i = Random::random(size - 1);
 
     // swap the randomly selected gene with the succeeding gene
-    swap_2_genes(i, i + 1);
-
-    sort();
+    return swap_positions(distance, i, i + 1);
 }
 
-void Chromosome::swap_2_random_genes()
+int Chromosome::swap_2_random_genes(int **distance)
 {
     // randomly select 2 genes
     int i = Random::random(size);
     int j = Random::random(size);
 
     // swap the 2 genes
-    swap_2_genes(i, j);
+    return swap_positions(distance, i, j);
+}
 
-    sort();
+// swaps the genes at positions i and j: only the edges starting at positions
+//   i - 1, i, j - 1 and j change (fewer when i and j are neighbours)
+int Chromosome::swap_positions(int **distance, int i, int j)
+{
+    if (i == j)
+        return 0;
+    int old_fitness = fitness;
+    int edges[4] = { (i + size - 1) % size, i, (j + size - 1) % size, j };
+    int num_edges = 0;
+    for (int k = 0; k < 4; k++)
+        if (std::find(edges, edges + num_edges, edges[k]) == edges + num_edges)
+            edges[num_edges++] = edges[k];
+    for (int k = 0; k < num_edges; k++)
+        change_edge(distance, genes[edges[k]], genes[(edges[k] + 1) % size], -1);
+    swap_2_genes(i, j);
+    for (int k = 0; k < num_edges; k++)
+        change_edge(distance, genes[edges[k]], genes[(edges[k] + 1) % size], 1);
+    return fitness - old_fitness;
 }
 
-void Chromosome::move_1_gene()
+int Chromosome::move_1_gene(int **distance)
 {
     // randomly select a gene
     int i = Random::random(size);
@@ -139,6 +144,33 @@ void Chromosome::move_1_gene()
     // randomly select a position
     int j = Random::random(size);
 
+    // moving the first gene to the end, or the last one to the start,
+    //   gives the same cycle
+    if (i == j || (i == 0 && j == size - 1) || (i == size - 1 && j == 0))
+    {
+        int temp = genes[i];
+        for (int k = i; k < j; k++)
+            genes[k] = genes[k + 1];
+        for (int k = i; k > j; k--)
+            genes[k] = genes[k - 1];
+        genes[j] = temp;
+        return 0;
+    }
+
+    // the gene leaves its neighbours and is inserted between genes[j] and
+    //   genes[j + 1] (moved forward) or genes[j - 1] and genes[j] (backward)
+    int old_fitness = fitness;
+    int gene = genes[i];
+    int prev = genes[(i + size - 1) % size], next = genes[(i + 1) % size];
+    int left = (i < j) ? genes[j] : genes[(j + size - 1) % size];
+    int right = (i < j) ? genes[(j + 1) % size] : genes[j];
+    change_edge(distance, prev, gene, -1);
+    change_edge(distance, gene, next, -1);
+    change_edge(distance, prev, next, 1);
+    change_edge(distance, left, right, -1);
+    change_edge(distance, left, gene, 1);
+    change_edge(distance, gene, right, 1);
+
     // move the gene to the randomly selected position
     int temp = genes[i];
     if (i < j)
@@ -152,16 +184,26 @@ void Chromosome::move_1_gene()
             genes[k] = genes[k - 1];
     }
     genes[j] = temp;
-
-    sort();
+    return fitness - old_fitness;
 }
 
-void Chromosome::invert_sequence_of_genes()
+int Chromosome::invert_sequence_of_genes(int **distance)
 {
     // randomly select two cut points
     int i = Random::random(size);
     int j = Random::random(size);
 
+    // the edges around the sequence change, unless it is the whole chromosome
+    int old_fitness = fitness;
+    if (i < j && j - i < size - 1)
+    {
+        int prev = genes[(i + size - 1) % size], next = genes[(j + 1) % size];
+        change_edge(distance, prev, genes[i], -1);
+        change_edge(distance, genes[j], next, -1);
+        change_edge(distance, prev, genes[j], 1);
+        change_edge(distance, genes[i], next, 1);
+    }
+
     // invert the sequence of genes between the two cut points
     while(i < j)
     {
@@ -169,23 +211,33 @@ void Chromosome::invert_sequence_of_genes()
         i++;
         j--;
     }
-
-    sort();
+    return fitness - old_fitness;
 }
 
-// display the parameters of a chromosome
+// display the parameters of a chromosome, sorted first
 void Chromosome::display()
 {
+    sort();
     cout << genes[0];
     for(int i = 1; i < size; i++)
         cout << "-" << genes[i];
     cout << " => fitness = " << fitness << endl;
 }
 
+// tests if 2 chromosomes are the same cycle: they are compared from city 0
+//   in both directions, so they do not need to be sorted
 bool Chromosome::identical(Chromosome* chrom)
 {
-    for(int i = 1; i < size; i++)
-        if (chrom->genes[i] != this->genes[i])
-            return false;
-    return true;
+    int p = std::find(genes, genes + size, 0) - genes;
+    int q = std::find(chrom->genes, chrom->genes + size, 0) - chrom->genes;
+    bool forward = true, backward = true;
+    for (int k = 1; k < size && (forward || backward); k++)
+    {
+        int gene = genes[(p + k) % size];
+        if (chrom->genes[(q + k) % size] != gene)
+            forward = false;
+        if (chrom->genes[(q - k + size) % size] != gene)
+            backward = false;
+    }
+    return forward || backward;
 }
@@ -4,7 +4,8 @@
 #include <math.h>
 #include <stdio.h>
 #include <iostream>
-#include "random.h"
+#include "../common/random.h"
+#include "../common/tour_hash.h"
 
 // The Chromosome class represents the structure of a solution to the problem
 class Chromosome {
@@ -13,28 +14,43 @@ public:
     int *genes;         // the genes of the chromosome/solution
     int size;           // the size of the chromosome = number of genes
     int fitness;        // the value of the objective function (fitness) of the solution
+    uint64_t hash;      // hash of the cycle, whatever its first gene and its orientation (TourHash)
+    bool owns_genes;    // false for a view on genes stored by a population
 
     // CONSTRUCTORS
     Chromosome(int cs); // constructor of the object randomly
+    Chromosome(int cs, int *storage);
+                        // constructor of a random view on the 'cs' genes at 'storage'
     ~Chromosome();      // destructor of the object
 
     // METHODS
-    void display();    // function to display the chromosome (i.e., the solution)
+    void display();    // function to display the chromosome (i.e., the solution), sorted first
     void evaluate(int **distance);
-                       // function to evaluate the chromosome (i.e., calculate the fitness)
+                       // function to evaluate the chromosome (i.e., calculate the fitness and the hash)
                        // It should be launched at the creation of the solution and after
                        // the execution of mutation and crossover operators
-    void sort();       // orders the sequence if gene[1] > gene[size - 1]
-    void copy(Chromosome* source);  // copies the 'source' chromosome
-    bool identical(Chromosome* chrom); // tests if 2 chromosomes are identical
+    void sort();       // starts the sequence with gene 0 and reverses it if gene[1] > gene[size - 1]
+                       // (in place, only needed to display the chromosome)
+    void copy(Chromosome* source);  // copies the 'source' chromosome, with its fitness and its hash
+    void random_genes();             // draws random genes, starting with gene 0
+    bool identical(Chromosome* chrom); // tests if 2 chromosomes are the same cycle, whatever their orientation
+
+    void change_edge(int **distance, int a, int b, int sign);
+                                     // adds (sign 1) or removes (sign -1) the edge (a, b) from the fitness and the hash
 
     // MUTATION OPERATORS
-    void swap_2_genes(int gene1,     // interchange 2 genes of the chromosome
+    // they update the fitness and the hash of an evaluated chromosome in place
+    //   and return the variation of the fitness
+    // They work on the genes array, not through Tour: a child is mutated once, right
+    //   after the crossover wrote its genes, and loading it in a Tour then storing it
+    //   back would cost O(n) against O(segment) for the inversion in the array
+    void swap_2_genes(int gene1,     // interchange 2 genes of the chromosome (genes only)
                       int gene2);
-    void swap_2_consecutive_genes(); // interchange 2 consecutive genes of the chromosome
-    void swap_2_random_genes();      // randomly interchange 2 genes of the chromosome
-    void move_1_gene();              // moves one gene in the chromosome
-    void invert_sequence_of_genes(); // inverts a sequence of genes in the chromosome
+    int swap_2_consecutive_genes(int **distance); // interchange 2 consecutive genes of the chromosome
+    int swap_2_random_genes(int **distance);      // randomly interchange 2 genes of the chromosome
+    int swap_positions(int **distance, int i, int j); // interchange the genes at positions i and j
+    int move_1_gene(int **distance);              // moves one gene in the chromosome
+    int invert_sequence_of_genes(int **distance); // inverts a sequence of genes in the chromosome
 };
 
 # endif
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#include <unordered_map>
+#include "ae.h"
+#include "../common/random.h"
+#include "../common/options.h"
+
+using namespace std;
+
+// Reference operators: the former quadratic implementations, used to check that
+//   the linear ones breed the same children and to measure the speedup
+
+// exchange sort of the positions begin..end-1 of a copy of 'parent' by position in 'other'
+static void reference_reorder(Chromosome* parent, Chromosome* other, Chromosome* child, int begin, int end,
+                              vector<int>& order_other)
+{
+    for (int i = 0; i < other->size; i++)
+        order_other[other->genes[i]] = i;
+    child->copy(parent);
+    for (int k = begin; k < end; k++)
+        for (int l = k + 1; l < end; l++)
+            if (order_other[child->genes[k]] > order_other[child->genes[l]])
+                child->swap_2_genes(k, l);
+}
+
+static void reference_1X(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2,
+                         vector<int>& scratch)
+{
+    int point = Random::random(parent1->size);
+    reference_reorder(parent1, parent2, child1, point + 1, parent1->size, scratch);
+    reference_reorder(parent2, parent1, child2, point + 1, parent1->size, scratch);
+}
+
+static void reference_2X(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2,
+                         vector<int>& scratch)
+{
+    int point1 = Random::random(parent1->size);
+    int point2 = Random::random(parent1->size);
+    if (point1 > point2)
+        std::swap(point1, point2);
+    reference_reorder(parent1, parent2, child1, point1 + 1, point2, scratch);
+    reference_reorder(parent2, parent1, child2, point1 + 1, point2, scratch);
+}
+
+// membership by scanning the copied segment
+static void reference_fill(Chromosome* parent, Chromosome* other, Chromosome* child, int point1, int point2)
+{
+    int num_genes = parent->size;
+    for (int i = point1; i <= point2; i++)
+        child->genes[i] = parent->genes[i];
+    int current_pos = (point2 + 1) % num_genes;
+    for (int i = 0; i < num_genes; i++) {
+        int gene = other->genes[(point2 + 1 + i) % num_genes];
+        bool already_present = false;
+        for (int j = point1; j <= point2; j++)
+            if (child->genes[j] == gene) {
+                already_present = true;
+                break;
+            }
+        if (!already_present) {
+            child->genes[current_pos] = gene;
+            current_pos = (current_pos + 1) % num_genes;
+        }
+    }
+}
+
+static void reference_2LOX(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2,
+                           vector<int>&)
+{
+    int point1 = Random::random(parent1->size);
+    int point2 = Random::random(parent1->size);
+    if (point1 > point2)
+        std::swap(point1, point2);
+    reference_fill(parent1, parent2, child1, point1, point2);
+    reference_fill(parent2, parent1, child2, point1, point2);
+}
+
+// mappings in hash tables built at each call
+static void reference_PMX(Chromosome* parent1, Chromosome* parent2, Chromosome* child1, Chromosome* child2,
+                          vector<int>&)
+{
+    int num_genes = parent1->size;
+    child1->copy(parent1);
+    child2->copy(parent2);
+    int point1 = Random::random(num_genes);
+    int point2 = Random::random(num_genes);
+    if (point1 > point2)
+        std::swap(point1, point2);
+    unordered_map<int, int> mapping1, mapping2;
+    for (int i = point1; i <= point2; i++) {
+        child1->genes[i] = parent2->genes[i];
+        child2->genes[i] = parent1->genes[i];
+        mapping1[parent2->genes[i]] = parent1->genes[i];
+        mapping2[parent1->genes[i]] = parent2->genes[i];
+    }
+    for (int i = 0; i < num_genes; i++) {
+        if (i >= point1 && i <= point2)
+            continue;
+        int gene = child1->genes[i];
+        while (mapping1.find(gene) != mapping1.end())
+            gene = mapping1[gene];
+        child1->genes[i] = gene;
+        gene = child2->genes[i];
+        while (mapping2.find(gene) != mapping2.end())
+            gene = mapping2[gene];
+        child2->genes[i] = gene;
+    }
+}
+
+typedef void (Ae::*Operator)(Chromosome*, Chromosome*, Chromosome*, Chromosome*, Workspace&);
+typedef void (*Reference)(Chromosome*, Chromosome*, Chromosome*, Chromosome*, vector<int>&);
+
+// number of crossovers per second of 'op' on pairs of parents of the population
+template <typename Call>
+double crossovers_per_second(Population* pop, Chromosome* child1, Chromosome* child2, int num_crossovers, Call call)
+{
+    auto start = chrono::high_resolution_clock::now();
+    for (int k = 0; k < num_crossovers; k++)
+        call(pop->individuals[k % pop->population_size], pop->individuals[(k + 1) % pop->population_size], child1, child2);
+    double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    return num_crossovers / seconds;
+}
+
+// Microbenchmark of the crossover operators of the genetic algorithm:
+//    1. TSP file, default value = data/a280.tsp
+//    2. number of crossovers per operator, default value = 20000
+// Named options: --seed n
+int main(int argc, char **argv)
+{
+    Options options(argc, argv);
+    argc = options.argc();
+    argv = options.argv();
+    uint64_t seed = options.has("seed") ? strtoull(options.get("seed", "0").c_str(), NULL, 10) : Random::clock_seed();
+    Random::set_seed(seed);
+    Random::randomize();
+
+    char tsp_file[100];
+    strcpy(tsp_file, (argc >= 2) ? argv[1] : "data/a280.tsp");
+    int num_crossovers = (argc >= 3) ? atoi(argv[2]) : 20000;
+
+    Ae algo(1, 16, 0.8, 0.5, tsp_file, 0, -1);
+    int n = algo.chromosome_size;
+    Workspace& ws = *algo.workspaces[0];
+    vector<int> scratch(n);
+    Chromosome child1(n), child2(n), expected1(n), expected2(n);
+
+    const char* names[4] = { "1X", "2X", "2LOX", "PMX" };
+    Operator operators[4] = { &Ae::crossover1X, &Ae::crossover2X, &Ae::crossover2LOX, &Ae::crossoverPMX };
+    Reference references[4] = { reference_1X, reference_2X, reference_2LOX, reference_PMX };
+
+    cout << "Crossovers on " << tsp_file << " (" << n << " cities)" << endl;
+    bool identical = true;
+    for (int o = 0; o < 4; o++)
+    {
+        // same children as the reference for the same random numbers
+        int differences = 0;
+        for (int k = 0; k < 200; k++)
+        {
+            Chromosome* parent1 = algo.pop->individuals[k % 16];
+            Chromosome* parent2 = algo.pop->individuals[(k + 3) % 16];
+            Random::set_seed(seed + k);
+            Random::randomize();
+            (algo.*operators[o])(parent1, parent2, &child1, &child2, ws);
+            Random::set_seed(seed + k);
+            Random::randomize();
+            references[o](parent1, parent2, &expected1, &expected2, scratch);
+            if (memcmp(child1.genes, expected1.genes, n * sizeof(int)) != 0
+                || memcmp(child2.genes, expected2.genes, n * sizeof(int)) != 0)
+                differences++;
+        }
+        identical = identical && differences == 0;
+
+        double linear = crossovers_per_second(algo.pop, &child1, &child2, num_crossovers,
+            [&](Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2) { (algo.*operators[o])(p1, p2, c1, c2, ws); });
+        double reference = crossovers_per_second(algo.pop, &expected1, &expected2, max(1, num_crossovers / 10),
+            [&](Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2) { references[o](p1, p2, c1, c2, scratch); });
+        cout << "   " << names[o] << "\t: " << (long long)linear << " crossovers/s (former operator: "
+             << (long long)reference << " crossovers/s, x" << linear / reference << ")";
+        if (differences > 0)
+            cout << ", " << differences << " / 200 different children";
+        cout << endl;
+    }
+
+    // EAX has no former version: rate and length of the children relative to their parents
+    algo.set_crossover_operator("eax");
+    double eax = crossovers_per_second(algo.pop, &child1, &child2, max(1, num_crossovers / 10),
+        [&](Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2) { algo.crossoverEAX(p1, p2, c1, c2, ws); });
+    double ratio = 0;
+    for (int k = 0; k < 200; k++)
+    {
+        Chromosome* parent1 = algo.pop->individuals[k % 16];
+        Chromosome* parent2 = algo.pop->individuals[(k + 3) % 16];
+        algo.crossoverEAX(parent1, parent2, &child1, &child2, ws);
+        child1.evaluate(algo.distances);
+        parent1->evaluate(algo.distances);
+        ratio += (double)child1.fitness / parent1->fitness / 200;
+    }
+    cout << "   EAX\t: " << (long long)eax << " crossovers/s, children " << ratio
+         << " times as long as their first parent" << endl;
+    return identical ? 0 : 1;
+}
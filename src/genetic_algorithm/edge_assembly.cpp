@@ -0,0 +1,273 @@
+#include <algorithm>
+#include "edge_assembly.h"
+#include "../common/random.h"
+
+// initialization of the scratch for n cities
+EdgeAssembly::EdgeAssembly(int n, int **distances, const vector<vector<int> >* neighbors, int max_tries)
+    : n(n), d(distances), neighbors(neighbors), max_tries(max_tries),
+      adj_a(2 * n), adj_b(2 * n), rem_a(2 * n), rem_b(2 * n), num_rem_a(n), num_rem_b(n),
+      pos_even(n, -1), pos_odd(n, -1), adj(2 * n), best_adj(2 * n), comp(n)
+{
+}
+
+// removes the edge (u, v) from lists of at most 2 edges per city
+void EdgeAssembly::remove_edge(vector<int>& adjacency, vector<int>& count, int u, int v)
+{
+    for (int k = 0; k < 2; k++)
+    {
+        int c = (k == 0) ? u : v, other = (k == 0) ? v : u;
+        if (adjacency[2 * c] == other)
+            adjacency[2 * c] = adjacency[2 * c + 1];
+        count[c]--;
+    }
+}
+
+// replaces the neighbour 'from' of c by 'to'
+void EdgeAssembly::replace(vector<int>& adjacency, int c, int from, int to)
+{
+    if (adjacency[2 * c] == from)
+        adjacency[2 * c] = to;
+    else
+        adjacency[2 * c + 1] = to;
+}
+
+// alternating walk: from the start city, the walk follows an A edge, then a B edge,
+//   and so on, each edge being used once. When it comes back to a city of the walk
+//   with the same parity, the closed part alternates A and B edges: it is stored
+//   as an AB-cycle and removed from the walk, which goes on from that city.
+void EdgeAssembly::build_ab_cycles()
+{
+    cycles.clear();
+    cycle_start.assign(1, 0);
+    for (int c = 0; c < n; c++)
+    {
+        num_rem_a[c] = num_rem_b[c] = 0;
+        for (int k = 0; k < 2; k++)
+        {
+            int a = adj_a[2 * c + k], b = adj_b[2 * c + k];
+            if (!in_b(c, a))
+                rem_a[2 * c + num_rem_a[c]++] = a;
+            if (adj_a[2 * c] != b && adj_a[2 * c + 1] != b)
+                rem_b[2 * c + num_rem_b[c]++] = b;
+        }
+    }
+
+    int offset = Random::random(n);
+    for (int t = 0; t < n; t++)
+    {
+        int s = (offset + t) % n;
+        if (num_rem_a[s] > 0)
+        {
+            path.assign(1, s);
+            pos_even[s] = 0;
+            while (!path.empty())
+            {
+                int k = (int)path.size() - 1;
+                int cur = path[k];
+                bool edge_a = (k % 2 == 0);
+                vector<int>& rem = edge_a ? rem_a : rem_b;
+                vector<int>& num_rem = edge_a ? num_rem_a : num_rem_b;
+                if (num_rem[cur] == 0)
+                {
+                    // the walk cannot go on (only at its start): drop it
+                    for (int i = 0; i <= k; i++)
+                        (i % 2 == 0 ? pos_even : pos_odd)[path[i]] = -1;
+                    break;
+                }
+                int w = rem[2 * cur + (num_rem[cur] == 2 ? Random::random(2) : 0)];
+                remove_edge(rem, num_rem, cur, w);
+                int index = k + 1;
+                vector<int>& pos = (index % 2 == 0) ? pos_even : pos_odd;
+                int j = pos[w];
+                if (j < 0)
+                {
+                    pos[w] = index;
+                    path.push_back(w);
+                    continue;
+                }
+
+                // AB-cycle path[j..k]: it starts with an A edge if j is even
+                for (int i = j + (j % 2); i <= k; i++)
+                    cycles.push_back(path[i]);
+                if (j % 2 == 1)
+                    cycles.push_back(path[j]);
+                cycle_start.push_back((int)cycles.size());
+                for (int i = j + 1; i <= k; i++)
+                    (i % 2 == 0 ? pos_even : pos_odd)[path[i]] = -1;
+                path.resize(j + 1);
+
+                // back to the start with no A edge left: the walk is over
+                if (j == 0 && num_rem_a[s] == 0)
+                {
+                    pos_even[s] = -1;
+                    path.clear();
+                }
+            }
+        }
+    }
+}
+
+// removes the A edges of AB-cycle k from A and adds its B edges
+long long EdgeAssembly::apply_cycle(int k)
+{
+    long long delta = 0;
+    adj = adj_a;
+    int first = cycle_start[k], length = cycle_start[k + 1] - first;
+    for (int i = 0; i < length; i += 2)
+    {
+        int u = cycles[first + i], v = cycles[first + i + 1];
+        replace(adj, u, v, -1);
+        replace(adj, v, u, -1);
+        delta -= d[u][v];
+    }
+    for (int i = 1; i < length; i += 2)
+    {
+        int u = cycles[first + i], v = cycles[first + (i + 1) % length];
+        replace(adj, u, -1, v);
+        replace(adj, v, -1, u);
+        delta += d[u][v];
+    }
+    return delta;
+}
+
+// labels the subtours, then merges the smallest one into another subtour
+//   until a single tour is left
+long long EdgeAssembly::merge_subtours()
+{
+    long long delta = 0;
+    int num_comps = 0;
+    for (int c = 0; c < n; c++)
+        comp[c] = -1;
+    for (int c = 0; c < n; c++)
+    {
+        if (comp[c] >= 0)
+            continue;
+        if ((int)comp_cities.size() <= num_comps)
+            comp_cities.push_back(vector<int>());
+        comp_cities[num_comps].clear();
+        int prev = -1, cur = c;
+        do
+        {
+            comp[cur] = num_comps;
+            comp_cities[num_comps].push_back(cur);
+            int next = (adj[2 * cur] != prev) ? adj[2 * cur] : adj[2 * cur + 1];
+            prev = cur;
+            cur = next;
+        } while (cur != c);
+        num_comps++;
+    }
+
+    for (int merges = 1; merges < num_comps; merges++)
+    {
+        // smallest subtour left
+        int smallest = -1;
+        for (int k = 0; k < num_comps; k++)
+            if (!comp_cities[k].empty() && (smallest < 0 || comp_cities[k].size() < comp_cities[smallest].size()))
+                smallest = k;
+
+        // best exchange of (u, u2) and (w, w2) for (u, w), (u2, w2) or (u, w2), (u2, w)
+        long long best = 0;
+        int best_u = -1, best_u2 = -1, best_w = -1, best_w2 = -1;
+        const vector<int>& cities = comp_cities[smallest];
+        for (size_t i = 0; i < cities.size(); i++)
+        {
+            int u = cities[i];
+            const vector<int>& near = (*neighbors)[u];
+            for (size_t l = 0; l < near.size(); l++)
+            {
+                int w = near[l];
+                if (comp[w] == smallest)
+                    continue;
+                for (int a = 0; a < 2; a++)
+                    for (int b = 0; b < 2; b++)
+                    {
+                        int u2 = adj[2 * u + a], w2 = adj[2 * w + b];
+                        long long gain = (long long)d[u][w] + d[u2][w2] - d[u][u2] - d[w][w2];
+                        if (best_u < 0 || gain < best)
+                        {
+                            best = gain;
+                            best_u = u; best_u2 = u2; best_w = w; best_w2 = w2;
+                        }
+                    }
+            }
+        }
+        // no neighbour in another subtour: link to any city of another subtour
+        if (best_u < 0)
+        {
+            best_u = cities[0];
+            best_u2 = adj[2 * best_u];
+            for (int c = 0; c < n && best_w < 0; c++)
+                if (comp[c] != smallest)
+                    best_w = c;
+            best_w2 = adj[2 * best_w];
+            best = (long long)d[best_u][best_w] + d[best_u2][best_w2] - d[best_u][best_u2] - d[best_w][best_w2];
+        }
+
+        replace(adj, best_u, best_u2, best_w);
+        replace(adj, best_w, best_w2, best_u);
+        replace(adj, best_u2, best_u, best_w2);
+        replace(adj, best_w2, best_w, best_u2);
+        delta += best;
+
+        int target = comp[best_w];
+        for (size_t i = 0; i < cities.size(); i++)
+        {
+            comp[cities[i]] = target;
+            comp_cities[target].push_back(cities[i]);
+        }
+        comp_cities[smallest].clear();
+    }
+    return delta;
+}
+
+// the child is the shortest tour obtained from up to 'max_tries' AB-cycles,
+//   or a copy of 'a' if the parents have the same edges
+void EdgeAssembly::cross(Chromosome* a, Chromosome* b, Chromosome* child)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int c = a->genes[i];
+        adj_a[2 * c] = a->genes[(i + n - 1) % n];
+        adj_a[2 * c + 1] = a->genes[(i + 1) % n];
+        c = b->genes[i];
+        adj_b[2 * c] = b->genes[(i + n - 1) % n];
+        adj_b[2 * c + 1] = b->genes[(i + 1) % n];
+    }
+    build_ab_cycles();
+
+    int num_cycles = (int)cycle_start.size() - 1;
+    if (num_cycles == 0)
+    {
+        child->copy(a);
+        return;
+    }
+
+    // random AB-cycles, without repetition
+    vector<int>& order = path;
+    order.resize(num_cycles);
+    for (int k = 0; k < num_cycles; k++)
+        order[k] = k;
+    long long best_delta = 0;
+    int tries = min(max_tries, num_cycles);
+    for (int t = 0; t < tries; t++)
+    {
+        swap(order[t], order[t + Random::random(num_cycles - t)]);
+        long long delta = apply_cycle(order[t]);
+        delta += merge_subtours();
+        if (t == 0 || delta < best_delta)
+        {
+            best_delta = delta;
+            best_adj.swap(adj);
+        }
+    }
+
+    // tour of the best intermediate solution, from city 0
+    int prev = -1, cur = 0;
+    for (int i = 0; i < n; i++)
+    {
+        child->genes[i] = cur;
+        int next = (best_adj[2 * cur] != prev) ? best_adj[2 * cur] : best_adj[2 * cur + 1];
+        prev = cur;
+        cur = next;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef EDGE_ASSEMBLY_H
+#define EDGE_ASSEMBLY_H
+
+#include <vector>
+#include "chromosome.h"
+
+using namespace std;
+
+// The EdgeAssembly class implements the Edge Assembly Crossover (EAX) of Nagata:
+// 1) the edges of parents A and B that are not common are split into AB-cycles,
+//    cycles whose edges alternately belong to A and to B
+// 2) an AB-cycle is applied to A: its A edges are removed and its B edges added,
+//    which gives a set of subtours (intermediate solution)
+// 3) the subtours are merged, the smallest first, by the best 2-opt exchange
+//    between one of its edges and an edge of another subtour reached through
+//    the neighbour lists
+// Several AB-cycles are tried and the shortest child is kept. Unlike the order
+//   based crossovers, the child is built from the edges of the parents.
+// One object per worker: it holds the scratch of the crossover.
+class EdgeAssembly {
+public:
+    // CONSTRUCTORS
+    EdgeAssembly(int n, int **distances, const vector<vector<int> >* neighbors, int max_tries);
+                        // constructor of the object, 'neighbors' = nearest cities of each city
+
+    // METHODS
+    void cross(Chromosome* a, Chromosome* b, Chromosome* child);
+                        // builds a child from the edges of 'a' and of an AB-cycle of 'a' and 'b'
+
+private:
+    int n;                              // number of cities
+    int **d;                            // distance matrix
+    const vector<vector<int> >* neighbors; // nearest cities of each city
+    int max_tries;                      // number of AB-cycles tried per child
+    vector<int> adj_a;                  // adj_a[2c], adj_a[2c+1] = neighbours of c in A
+    vector<int> adj_b;                  // neighbours of c in B
+    vector<int> rem_a;                  // A edges of c not yet in an AB-cycle (not common)
+    vector<int> rem_b;                  // B edges of c not yet in an AB-cycle (not common)
+    vector<int> num_rem_a;              // number of edges in rem_a
+    vector<int> num_rem_b;              // number of edges in rem_b
+    vector<int> path;                   // alternating walk in progress
+    vector<int> pos_even;               // index of c at an even position of the walk, -1 if none
+    vector<int> pos_odd;                // index of c at an odd position of the walk, -1 if none
+    vector<int> cycles;                 // cities of the AB-cycles, the first edge of each belongs to A
+    vector<int> cycle_start;            // first index of each AB-cycle in 'cycles', plus the end
+    vector<int> adj;                    // intermediate solution: neighbours of each city
+    vector<int> best_adj;               // shortest child found
+    vector<int> comp;                   // subtour of each city
+    vector<vector<int> > comp_cities;   // cities of each subtour
+
+    static void remove_edge(vector<int>& adjacency, vector<int>& count, int u, int v);
+    static void replace(vector<int>& adjacency, int c, int from, int to);
+    bool in_b(int u, int v) const { return adj_b[2 * u] == v || adj_b[2 * u + 1] == v; }
+    void build_ab_cycles();             // splits the edges of A and B that are not common into AB-cycles
+    long long apply_cycle(int k);       // intermediate solution of AB-cycle k, returns the variation of length
+    long long merge_subtours();         // merges the subtours of the intermediate solution, returns the variation of length
+};
+
+# endif
@@ -0,0 +1,96 @@
+#include "edge_frequency.h"
+
+// initialization of the counts of the tours of p individuals of n cities:
+//   the table is at most half full
+EdgeFrequency::EdgeFrequency(int n, int p)
+{
+    num_cities = n;
+    num_tours = p;
+    uint64_t max_edges = (uint64_t)n * p;
+    if (max_edges > (uint64_t)n * (n - 1) / 2)
+        max_edges = (uint64_t)n * (n - 1) / 2;
+    uint64_t size = 16;
+    shift = 60;
+    while (size < 2 * max_edges)
+    {
+        size *= 2;
+        shift--;
+    }
+    mask = size - 1;
+    keys = new uint64_t[size];
+    count = new int[size];
+    // a tour of 2 cities has the same edge twice
+    xlogx = new double[2 * num_tours + 1];
+    for (int f = 0; f <= 2 * num_tours; f++)
+        xlogx[f] = (f > 0) ? f * log((double)f) : 0;
+    clear();
+}
+
+// destruction of the "EdgeFrequency" object
+EdgeFrequency::~EdgeFrequency()
+{
+    delete[] keys;
+    delete[] count;
+    delete[] xlogx;
+}
+
+void EdgeFrequency::clear()
+{
+    for (uint64_t slot = 0; slot <= mask; slot++)
+        keys[slot] = 0;
+    sum = 0;
+}
+
+// the edges of a tour are (genes[i], genes[i + 1]) and the closing edge
+void EdgeFrequency::add(const int *genes)
+{
+    for (int i = 0; i < num_cities - 1; i++)
+        change(genes[i], genes[i + 1], 1);
+    change(genes[num_cities - 1], genes[0], 1);
+}
+
+void EdgeFrequency::remove(const int *genes)
+{
+    for (int i = 0; i < num_cities - 1; i++)
+        change(genes[i], genes[i + 1], -1);
+    change(genes[num_cities - 1], genes[0], -1);
+}
+
+// the key a * n + b (a < b) is never 0. An edge counted by no tour leaves the
+//   table: the following entries of its probe sequence are shifted back
+//   into the hole when it lies between their home slot and them
+void EdgeFrequency::change(int a, int b, int delta)
+{
+    if (a > b)
+    {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    uint64_t key = (uint64_t)a * num_cities + b;
+    uint64_t slot = home(key);
+    while (keys[slot] != 0 && keys[slot] != key)
+        slot = (slot + 1) & mask;
+    if (keys[slot] == 0)
+    {
+        keys[slot] = key;
+        count[slot] = 0;
+    }
+    sum += xlogx[count[slot] + delta] - xlogx[count[slot]];
+    count[slot] += delta;
+    if (count[slot] > 0)
+        return;
+
+    uint64_t hole = slot;
+    for (uint64_t next = (hole + 1) & mask; keys[next] != 0; next = (next + 1) & mask)
+    {
+        // the entry may move to the hole if its home slot is not in (hole, next]
+        if (((next - home(keys[next])) & mask) >= ((next - hole) & mask))
+        {
+            keys[hole] = keys[next];
+            count[hole] = count[next];
+            hole = next;
+        }
+    }
+    keys[hole] = 0;
+}
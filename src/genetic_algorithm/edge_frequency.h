@@ -0,0 +1,52 @@
+#ifndef EDGE_FREQUENCY_H
+#define EDGE_FREQUENCY_H
+
+#include <math.h>
+#include <stdint.h>
+
+// The EdgeFrequency class counts the edges of the tours of a population, kept up
+//   to date as tours are added and removed, to measure its diversity in O(1).
+// With f_e the count of edge e among the n * P edges of P tours of n cities, the
+//   edge entropy is H = -sum p_e log p_e with p_e = f_e / (n * P). It ranges from
+//   log n (P copies of one tour) to log(n * P) (no shared edge), so the diversity
+//   (H - log n) / log P is between 0 and 1. Adding or removing an edge changes
+//   the sum S = sum f_e log f_e by one term, and H = log(n * P) - S / (n * P).
+// The counts are stored in an open addressing table (linear probing) keyed by
+//   a * n + b for the edge (a, b), a < b, sized for the n * P distinct edges of
+//   P tours without a common edge, so that an edge is found in O(1).
+class EdgeFrequency {
+public:
+    // ATTRIBUTES
+    int num_cities;       // number of cities n
+    int num_tours;        // number of tours P counted when full
+    uint64_t mask;        // size of the table minus 1 (a power of 2 minus 1)
+    int shift;            // 64 - log2 of the size of the table
+    uint64_t *keys;       // key of the edge of each slot, 0 if the slot is empty
+    int *count;           // number of tours with the edge of each slot
+    double *xlogx;        // xlogx[f] = f log f, f = 0..2P
+    double sum;           // S = sum of f_e log f_e over the edges
+
+    // CONSTRUCTORS
+    EdgeFrequency(int n, int p); // constructor of the object, no tour counted
+    ~EdgeFrequency();            // destructor of the object
+
+    // METHODS
+    void clear();                // forgets all the tours
+    void add(const int *genes);    // counts the edges of a tour
+    void remove(const int *genes); // uncounts the edges of a tour, counted before
+    double diversity()             // diversity of P tours, between 0 and 1 (0 below 4 cities: a single cycle)
+    {
+        double total = (double)num_cities * num_tours;
+        if (num_tours < 2 || num_cities < 4)
+            return 0;
+        return (log(total) - sum / total - log((double)num_cities)) / log((double)num_tours);
+    }
+
+private:
+    uint64_t home(uint64_t key) { return (key * 0x9E3779B97F4A7C15ULL) >> shift; } // first slot probed for a key
+    void change(int a, int b, int delta); // adds delta (1 or -1) to the count of the edge (a, b)
+    EdgeFrequency(const EdgeFrequency&);
+    EdgeFrequency& operator=(const EdgeFrequency&);
+};
+
+# endif
@@ -0,0 +1,63 @@
+#include "fenwick_tree.h"
+
+// initialization of a tree of n null values
+FenwickTree::FenwickTree(int n)
+{
+    size = n;
+    value = new long long[size];
+    tree = new long long[size + 1];
+    for (int i = 0; i < size; i++)
+        value[i] = 0;
+    for (int k = 0; k <= size; k++)
+        tree[k] = 0;
+    top = 1;
+    while (2 * top <= size)
+        top *= 2;
+}
+
+// destruction of the "FenwickTree" object
+FenwickTree::~FenwickTree()
+{
+    delete[] value;
+    delete[] tree;
+}
+
+// changes one value: the nodes covering index i receive the difference
+void FenwickTree::set(int i, long long v)
+{
+    long long difference = v - value[i];
+    value[i] = v;
+    for (int k = i + 1; k <= size; k += k & (-k))
+        tree[k] += difference;
+}
+
+// sum of the values
+long long FenwickTree::total()
+{
+    long long sum = 0;
+    for (int k = size; k > 0; k -= k & (-k))
+        sum += tree[k];
+    return sum;
+}
+
+// weighted draw by descent of the tree: node k reached from 'position' by a
+//   step covers exactly 'step' indices, so its weight is base * step + sign * tree[k]
+int FenwickTree::find(double target, long long base, int sign)
+{
+    int position = 0;
+    for (int step = top; step > 0; step /= 2)
+    {
+        int k = position + step;
+        if (k <= size)
+        {
+            long long weight = base * step + sign * tree[k];
+            if (weight <= target)
+            {
+                target -= weight;
+                position = k;
+            }
+        }
+    }
+    // rounding errors may lead past the last index
+    return position < size ? position : size - 1;
+}
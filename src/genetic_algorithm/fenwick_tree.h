@@ -0,0 +1,30 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+// The FenwickTree class stores n integer values and their prefix sums,
+//   so that a value can be changed and a weighted draw made in O(log n).
+// The weight of value i in a draw is base + sign * value[i]: the fitness
+//   for the replacement (base = 0, sign = 1), and the margin to the worst
+//   fitness for the selection (base = worst fitness, sign = -1), without
+//   rebuilding the tree when the worst fitness changes.
+class FenwickTree {
+public:
+    // ATTRIBUTES
+    int size;          // number of values
+    long long *value;  // value[i] = i-th value
+    long long *tree;   // tree[k] = sum of the values of indices k - lowbit(k) .. k - 1 (k = 1..size)
+    int top;           // largest power of 2 not above size
+
+    // CONSTRUCTORS
+    FenwickTree(int n); // constructor of the object, all the values are 0
+    ~FenwickTree();     // destructor of the object
+
+    // METHODS
+    void set(int i, long long v);   // sets value i to v
+    long long total();              // sum of the values
+    int find(double target, long long base, int sign);
+                       // smallest index i such that the sum of the weights
+                       // of the indices 0..i is larger than 'target'
+};
+
+# endif
@@ -0,0 +1,64 @@
+#include "hash_count.h"
+
+// initialization of the counts of p individuals: the table is at most half full
+HashCount::HashCount(int p)
+{
+    uint64_t size = 16;
+    shift = 60;
+    while (size < 2 * (uint64_t)p)
+    {
+        size *= 2;
+        shift--;
+    }
+    mask = size - 1;
+    keys = new uint64_t[size];
+    count = new int[size];
+    clear();
+}
+
+// destruction of the "HashCount" object
+HashCount::~HashCount()
+{
+    delete[] keys;
+    delete[] count;
+}
+
+void HashCount::clear()
+{
+    for (uint64_t slot = 0; slot <= mask; slot++)
+        count[slot] = 0;
+}
+
+void HashCount::add(uint64_t hash)
+{
+    uint64_t slot = home(hash);
+    while (count[slot] != 0 && keys[slot] != hash)
+        slot = (slot + 1) & mask;
+    keys[slot] = hash;
+    count[slot]++;
+}
+
+// a hash counted by no individual leaves the table: the following entries of
+//   its probe sequence are shifted back into the hole when it lies between
+//   their home slot and them (no tombstone, so the probes stay short)
+void HashCount::remove(uint64_t hash)
+{
+    uint64_t slot = home(hash);
+    while (keys[slot] != hash)
+        slot = (slot + 1) & mask;
+    if (--count[slot] > 0)
+        return;
+
+    uint64_t hole = slot;
+    for (uint64_t next = (hole + 1) & mask; count[next] != 0; next = (next + 1) & mask)
+    {
+        // the entry may move to the hole if its home slot is not in (hole, next]
+        if (((next - home(keys[next])) & mask) >= ((next - hole) & mask))
+        {
+            keys[hole] = keys[next];
+            count[hole] = count[next];
+            hole = next;
+        }
+    }
+    count[hole] = 0;
+}
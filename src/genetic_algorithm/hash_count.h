@@ -0,0 +1,41 @@
+#ifndef HASH_COUNT_H
+#define HASH_COUNT_H
+
+#include <stdint.h>
+
+// The HashCount class counts the individuals of a population with each hash,
+//   to find the duplicates in O(1). The counts are stored in an open addressing
+//   table (linear probing) of at least twice as many slots as individuals,
+//   allocated once: at most half full, and a hash counted by no individual
+//   leaves the table, so that a replacement never allocates memory.
+class HashCount {
+public:
+    // ATTRIBUTES
+    uint64_t mask;        // size of the table minus 1 (a power of 2 minus 1)
+    int shift;            // 64 - log2 of the size of the table
+    uint64_t *keys;       // hash of each slot
+    int *count;           // number of individuals with the hash of each slot, 0 if the slot is empty
+
+    // CONSTRUCTORS
+    HashCount(int p);     // constructor of the object for p individuals, no hash counted
+    ~HashCount();         // destructor of the object
+
+    // METHODS
+    void clear();             // forgets all the hashes
+    void add(uint64_t hash);    // counts one more individual with the hash
+    void remove(uint64_t hash); // counts one less individual with the hash, counted before
+    int get(uint64_t hash)      // number of individuals with the hash
+    {
+        uint64_t slot = home(hash);
+        while (count[slot] != 0 && keys[slot] != hash)
+            slot = (slot + 1) & mask;
+        return count[slot];
+    }
+
+private:
+    uint64_t home(uint64_t hash) { return (hash * 0x9E3779B97F4A7C15ULL) >> shift; } // first slot probed for a hash
+    HashCount(const HashCount&);
+    HashCount& operator=(const HashCount&);
+};
+
+# endif
@@ -0,0 +1,127 @@
+#include "island_model.h"
+
+using namespace std;
+
+// creates the islands and the mailboxes of the topology
+IslandModel::IslandModel(Ae* model, int k, Topology t, int interval, int migrants)
+{
+    num_islands = max(1, k);
+    topology = t;
+    migration_interval = max(1, interval);
+    num_migrants = max(1, min(migrants, model->population_size));
+
+    islands.push_back(model);
+    for (int i = 1; i < num_islands; i++)
+        islands.push_back(new Ae(*model, 0));
+
+    // every island breeds batches like the model; each (island, worker) pair has its own
+    //   random stream, 1 + island * num_workers + worker (stream 0 is the main thread)
+    num_workers = model->pool ? model->pool->size : 1;
+    if (model->batch_size > 0)
+        for (int i = 0; i < num_islands; i++)
+            islands[i]->set_batch(model->batch_size, num_workers, 1 + i * num_workers);
+
+    // a mailbox holds the migrants of a few migrations, in case the receiver is late
+    mailboxes.assign(num_islands * num_islands, NULL);
+    for (int from = 0; from < num_islands; from++)
+        for (int to = 0; to < num_islands; to++)
+        {
+            bool connected = (from != to) && (topology != TOPOLOGY_RING || to == (from + 1) % num_islands);
+            if (connected)
+                mailboxes[from * num_islands + to] = new Mailbox(4 * num_migrants, model->chromosome_size);
+        }
+
+    for (int i = 0; i < num_islands; i++)
+    {
+        received.push_back(new Chromosome(model->chromosome_size));
+        islands[i]->islands = this;
+        islands[i]->island = i;
+        islands[i]->report = false;
+    }
+}
+
+// destruction of the "IslandModel" object
+IslandModel::~IslandModel()
+{
+    for (int i = 1; i < num_islands; i++)
+        delete islands[i];
+    for (size_t k = 0; k < mailboxes.size(); k++)
+        delete mailboxes[k];
+    for (int i = 0; i < num_islands; i++)
+        delete received[i];
+}
+
+// reads the name of a topology
+bool IslandModel::parse_topology(const string& name, Topology& topology)
+{
+    if (name == "ring")
+        topology = TOPOLOGY_RING;
+    else if (name == "random")
+        topology = TOPOLOGY_RANDOM;
+    else if (name == "full")
+        topology = TOPOLOGY_FULL;
+    else
+        return false;
+    return true;
+}
+
+// runs island i on thread i (stream 1 + i * num_workers of the seed, its worker 0),
+//   then reports each island
+Chromosome* IslandModel::optimize()
+{
+    vector<Chromosome*> bests(num_islands);
+    vector<thread> threads;
+    for (int i = 0; i < num_islands; i++)
+        threads.push_back(thread([this, i, &bests]() {
+            Random::randomize(1 + i * num_workers);
+            bests[i] = islands[i]->optimize();
+        }));
+    for (int i = 0; i < num_islands; i++)
+        threads[i].join();
+
+    int best = 0;
+    for (int i = 0; i < num_islands; i++)
+    {
+        cout << "Island " << i << endl;
+        islands[i]->pop->statistics();
+        islands[i]->pop->similarity();
+        cout << endl;
+        if (bests[i]->fitness < bests[best]->fitness)
+            best = i;
+    }
+    return bests[best];
+}
+
+// migration of island i: its best individuals are sent to its destinations,
+//   then the migrants waiting in its mailboxes replace its worst individuals
+void IslandModel::migrate(int i)
+{
+    if (num_islands == 1)
+        return;
+    Population* pop = islands[i]->pop;
+
+    // destinations
+    int first = 0, last = num_islands - 1;
+    if (topology == TOPOLOGY_RING)
+        first = last = (i + 1) % num_islands;
+    else if (topology == TOPOLOGY_RANDOM)
+    {
+        first = Random::random(num_islands - 1);
+        if (first >= i)
+            first++;
+        last = first;
+    }
+    for (int to = first; to <= last; to++)
+        if (to != i)
+            for (int m = 0; m < num_migrants; m++)
+                mailboxes[i * num_islands + to]->send(pop->individuals[pop->order[m]]);
+
+    // arrivals
+    for (int from = 0; from < num_islands; from++)
+    {
+        Mailbox* mailbox = mailboxes[from * num_islands + i];
+        if (mailbox)
+            while (mailbox->receive(received[i]))
+                pop->worst_replacement(received[i]);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "ae.h"
+#include "mailbox.h"
+
+// Topologies of the migrations
+enum Topology {
+    TOPOLOGY_RING,   // island i sends to island i + 1
+    TOPOLOGY_RANDOM, // island i sends to another island drawn at each migration
+    TOPOLOGY_FULL    // island i sends to all the other islands
+};
+
+// The IslandModel class evolves K populations on K threads. Every
+//   'migration_interval' generations, each island sends copies of its best
+//   individuals to its neighbours in the topology and inserts the migrants
+//   it received in place of its worst individuals. Each directed pair of
+//   islands has its own single-producer / single-consumer mailbox, so the
+//   islands never wait for each other and never take a lock.
+class IslandModel {
+public:
+    // ATTRIBUTES
+    int num_islands;          // number of islands (and threads)
+    vector<Ae*> islands;      // the evolutionary algorithm of each island, islands[0] is the model
+    Topology topology;        // destinations of the migrants
+    int migration_interval;   // number of generations between two migrations
+    int num_migrants;         // number of best individuals sent to each destination
+    int num_workers;          // workers breeding the batches of each island (1 if not batched)
+    vector<Mailbox*> mailboxes; // mailboxes[from * num_islands + to], NULL if the pair is not connected
+    vector<Chromosome*> received; // scratch of each island receiving a migrant
+
+    // CONSTRUCTORS
+    IslandModel(Ae* model, int num_islands, Topology topology, int migration_interval, int num_migrants);
+                              // constructor of the object, the islands share the distances of 'model'
+    ~IslandModel();           // destructor of the object (islands[0] is not deleted)
+
+    // METHODS
+    static bool parse_topology(const std::string& name, Topology& topology);
+                              // reads "ring", "random" or "full"
+    Chromosome* optimize();   // runs the islands in parallel, returns the best individual
+    void migrate(int island); // sends the best individuals of 'island' and inserts the migrants it received
+};
+
+# endif
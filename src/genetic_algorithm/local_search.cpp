@@ -0,0 +1,225 @@
+#include "local_search.h"
+#include "../common/random.h"
+
+// initialization of the scratch for n cities
+LocalSearch::LocalSearch(int n, int **distances, const vector<vector<int> >* neighbors, int max_moves)
+    : n(n), d(distances), neighbors(neighbors), max_moves(max_moves), t(NULL),
+      pos(n), queued(n), queue(n), queue_head(0), queue_size(0)
+{
+}
+
+void LocalSearch::activate(int c)
+{
+    if (!queued[c])
+    {
+        queued[c] = 1;
+        int tail = queue_head + queue_size++;
+        queue[tail < n ? tail : tail - n] = c;
+    }
+}
+
+// the path from..to and the rest of the cycle give the same tour once
+//   reversed: the shorter of the two is reversed
+void LocalSearch::reverse(int from, int to)
+{
+    int i = pos[from], j = pos[to];
+    int length = (j - i + n) % n + 1;
+    if (2 * length > n)
+    {
+        i = (j + 1) % n;
+        j = (pos[from] - 1 + n) % n;
+        length = n - length;
+    }
+    for (int k = 0; k < length / 2; k++)
+    {
+        int u = t[i], v = t[j];
+        t[i] = v; pos[v] = i;
+        t[j] = u; pos[u] = j;
+        i = (i + 1 == n) ? 0 : i + 1;
+        j = (j == 0) ? n - 1 : j - 1;
+    }
+}
+
+// 2-opt move removing an edge of a: as the neighbours are sorted, the search
+//   stops once the new edge (a, c) is not shorter than the removed one
+int LocalSearch::two_opt(int a)
+{
+    const vector<int>& near = (*neighbors)[a];
+    int best = 0, best_c = -1, best_dir = 0;
+    for (int dir = 0; dir < 2; dir++)
+    {
+        int b = dir == 0 ? next(a) : prev(a);
+        int d_ab = d[a][b];
+        for (size_t k = 0; k < near.size(); k++)
+        {
+            int c = near[k];
+            if (d[a][c] >= d_ab)
+                break;
+            int e = dir == 0 ? next(c) : prev(c);
+            if (c == b || e == a)
+                continue;
+            int delta = d[a][c] + d[b][e] - d_ab - d[c][e];
+            if (delta < best)
+            {
+                best = delta;
+                best_c = c;
+                best_dir = dir;
+            }
+        }
+    }
+    if (best_c < 0)
+        return 0;
+
+    int c = best_c;
+    if (best_dir == 0)
+    {
+        // a b ... c e becomes a c ... b e
+        int b = next(a), e = next(c);
+        reverse(b, c);
+        activate(b);
+        activate(e);
+    }
+    else
+    {
+        // e c ... b a becomes e b ... c a
+        int b = prev(a), e = prev(c);
+        reverse(c, b);
+        activate(b);
+        activate(e);
+    }
+    activate(a);
+    activate(c);
+    return -best;
+}
+
+// Or-opt move of the segment a..last (1 to 3 genes) between g1 and g2 = next(g1),
+//   the gene of the segment next to a neighbour c of a being a
+int LocalSearch::or_opt(int a)
+{
+    if (n < 8)
+        return 0;
+    const vector<int>& near = (*neighbors)[a];
+    int best = 0, best_len = 0, best_g1 = -1;
+    bool best_reversed = false;
+    int p = prev(a);
+    int last = a;
+    for (int len = 1; len <= 3; len++)
+    {
+        if (len > 1)
+            last = next(last);
+        int nx = next(last);
+        int removed = d[p][a] + d[last][nx] - d[p][nx];
+        for (size_t k = 0; k < near.size(); k++)
+        {
+            int c = near[k];
+            if (d[a][c] >= removed)
+                break;
+            if ((pos[c] - pos[a] + n) % n < len)
+                continue;
+            // c before the segment (g1 = c, a first) or after it (g2 = c, a last)
+            for (int side = 0; side < 2; side++)
+            {
+                int g1 = side == 0 ? c : prev(c);
+                int g2 = side == 0 ? next(c) : c;
+                if ((pos[g1] - pos[a] + n) % n < len || (pos[g2] - pos[a] + n) % n < len)
+                    continue;
+                int added = side == 0 ? d[g1][a] + d[last][g2] : d[g1][last] + d[a][g2];
+                int delta = added - d[g1][g2] - removed;
+                if (delta < best)
+                {
+                    best = delta;
+                    best_len = len;
+                    best_g1 = g1;
+                    best_reversed = (side == 1);
+                }
+            }
+        }
+    }
+    if (best_g1 < 0)
+        return 0;
+
+    // the genes between the segment and the gap, on the shorter side, are shifted
+    int segment[3];
+    int start = pos[a];
+    for (int k = 0; k < best_len; k++)
+        segment[k] = t[(start + k) % n];
+    int nx = t[(start + best_len) % n];
+    int g2 = next(best_g1);
+    int between = (pos[best_g1] - pos[nx] + n) % n + 1; // genes nx..g1
+    if (between <= n - best_len - between)
+    {
+        // p [segment] nx..g1 g2 becomes p nx..g1 [segment] g2
+        for (int k = 0; k < between; k++)
+        {
+            int c = t[(start + best_len + k) % n];
+            int i = (start + k) % n;
+            t[i] = c;
+            pos[c] = i;
+        }
+        start = (start + between) % n;
+    }
+    else
+    {
+        // g1 g2..p [segment] becomes g1 [segment] g2..p
+        int other = n - best_len - between; // genes g2..p
+        int base = pos[g2];
+        for (int k = other - 1; k >= 0; k--)
+        {
+            int c = t[(base + k) % n];
+            int i = (base + k + best_len) % n;
+            t[i] = c;
+            pos[c] = i;
+        }
+        start = (start - other + n) % n;
+    }
+    for (int k = 0; k < best_len; k++)
+    {
+        int c = segment[best_reversed ? best_len - 1 - k : k];
+        int i = (start + k) % n;
+        t[i] = c;
+        pos[c] = i;
+    }
+    activate(p);
+    activate(nx);
+    activate(best_g1);
+    activate(g2);
+    for (int k = 0; k < best_len; k++)
+        activate(segment[k]);
+    return -best;
+}
+
+// 2-opt and Or-opt moves from the queued cities until a local optimum or the
+//   budget of moves is reached
+int LocalSearch::improve(Chromosome* chrom)
+{
+    t = chrom->genes;
+    queue_head = 0;
+    queue_size = 0;
+    for (int i = 0; i < n; i++)
+    {
+        pos[t[i]] = i;
+        queued[i] = 0;
+    }
+    // cities in random order, so that the budget is not always spent on the same ones
+    int offset = Random::random(n);
+    for (int i = 0; i < n; i++)
+        activate(t[(offset + i) % n]);
+
+    int total = 0, moves = 0;
+    while (queue_size > 0 && (max_moves <= 0 || moves < max_moves))
+    {
+        int a = queue[queue_head];
+        queue_head = (queue_head + 1 == n) ? 0 : queue_head + 1;
+        queue_size--;
+        queued[a] = 0;
+        int gain = two_opt(a);
+        if (gain == 0)
+            gain = or_opt(a);
+        if (gain > 0)
+        {
+            total += gain;
+            moves++;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,50 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <vector>
+#include "chromosome.h"
+
+using namespace std;
+
+// The LocalSearch class improves a chromosome with 2-opt and Or-opt moves
+//   (memetic step of the genetic algorithm):
+// - 2-opt: the edge (a, next a) or (prev a, a) is replaced by an edge from a
+//   to one of its nearest neighbours c, and the path in between is reversed
+// - Or-opt: the segment of 1 to 3 genes starting at a is moved next to one of
+//   the nearest neighbours of a, in either orientation
+// Each move is evaluated by its variation of length only (delta). The cities
+//   whose edges changed are queued again (don't-look bits), and the search
+//   stops at a local optimum or once 'max_moves' moves have been applied.
+// One object per worker: it holds the scratch of the search.
+class LocalSearch {
+public:
+    // CONSTRUCTORS
+    LocalSearch(int n, int **distances, const vector<vector<int> >* neighbors, int max_moves);
+                        // constructor of the object, 'neighbors' = nearest cities of each city,
+                        // 'max_moves' = number of moves applied per call (0 for no limit)
+
+    // METHODS
+    int improve(Chromosome* chrom);
+                        // improves the genes of 'chrom' in place, returns the decrease of its length
+
+private:
+    int n;                              // number of cities
+    int **d;                            // distance matrix
+    const vector<vector<int> >* neighbors; // nearest cities of each city
+    int max_moves;                      // number of moves applied per call, 0 for no limit
+    int *t;                             // genes being improved
+    vector<int> pos;                    // position of each city in t
+    vector<char> queued;                // true if the city is in the queue
+    vector<int> queue;                  // cities to start a move from (circular, a city is queued once)
+    int queue_head;                     // index of the first city of the queue
+    int queue_size;                     // number of cities in the queue
+
+    int next(int c) const { int p = pos[c] + 1; return t[p == n ? 0 : p]; }
+    int prev(int c) const { int p = pos[c] - 1; return t[p < 0 ? n - 1 : p]; }
+    void activate(int c);               // queues city c
+    void reverse(int from, int to);     // reverses the path from..to (read forward)
+    int two_opt(int a);                 // best 2-opt move from a, applied if improving, returns its gain
+    int or_opt(int a);                  // best Or-opt move of a segment starting at a, returns its gain
+};
+
+# endif
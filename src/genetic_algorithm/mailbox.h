@@ -0,0 +1,70 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include "chromosome.h"
+
+// The Mailbox class is a lock-free single-producer / single-consumer queue of
+//   chromosomes: one island sends its migrants, one island receives them.
+//   The slots are allocated once; the producer copies the genes into the slot
+//   at 'tail' before publishing it, the consumer copies them out before
+//   releasing the slot at 'head'. A full mailbox drops the new migrants.
+class Mailbox {
+public:
+    // ATTRIBUTES
+    int capacity;                 // number of slots
+    int genes_size;               // number of genes of a chromosome
+    int *genes;                   // genes of the slots, capacity * genes_size
+    int *fitness;                 // fitness of the chromosome of each slot
+    uint64_t *hashes;             // hash of the chromosome of each slot
+    std::atomic<unsigned> head;   // number of chromosomes received (written by the consumer)
+    std::atomic<unsigned> tail;   // number of chromosomes sent (written by the producer)
+
+    // CONSTRUCTORS
+    Mailbox(int capacity, int genes_size) : capacity(capacity), genes_size(genes_size), head(0), tail(0)
+    {
+        genes = new int[capacity * genes_size];
+        fitness = new int[capacity];
+        hashes = new uint64_t[capacity];
+    }
+    ~Mailbox()
+    {
+        delete[] genes;
+        delete[] fitness;
+        delete[] hashes;
+    }
+
+    // METHODS
+    bool send(Chromosome* chrom)     // called by the producer only, false if the mailbox is full
+    {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == (unsigned)capacity)
+            return false;
+        int slot = t % capacity;
+        for (int i = 0; i < genes_size; i++)
+            genes[slot * genes_size + i] = chrom->genes[i];
+        fitness[slot] = chrom->fitness;
+        hashes[slot] = chrom->hash;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool receive(Chromosome* chrom)  // called by the consumer only, false if the mailbox is empty
+    {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        int slot = h % capacity;
+        for (int i = 0; i < genes_size; i++)
+            chrom->genes[i] = genes[slot * genes_size + i];
+        chrom->fitness = fitness[slot];
+        chrom->hash = hashes[slot];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    Mailbox(const Mailbox&);
+    Mailbox& operator=(const Mailbox&);
+};
+
+# endif
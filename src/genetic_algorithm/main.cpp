@@ -2,9 +2,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <iostream>
+#include <thread>
 #include "ae.h"
+#include "island_model.h"
 #include "chromosome.h"
-#include "random.h"
+#include "../common/random.h"
+#include "../common/options.h"
 
 using namespace std;
 
@@ -19,8 +22,44 @@ int main(int argc, char **argv)
 //    5. name of the file indicating the distances between cities
 //    6. verbose (optional)
 //    7. max_duration_seconds (optional)
+// Named options ("--name value" or "--name=value") may be given anywhere after the executable name,
+//   the flag --reject-duplicates takes no value:
+//    --init method  : heuristic building the first individual among random, nn, greedy, sfc and savings, default random
+//    --crossover-operator x : crossover among 1x, 2x, 2lox, pmx, eax (Edge Assembly) and adaptive, default 2x
+//    --selection-operator x : selection among roulette, random and ranking, default roulette
+//    --mutation-operator x : mutation among swap, random-swap, move, invert and adaptive, default invert
+//                             (adaptive: drawn at each call, in proportion to the improvement per cycle of each operator)
+//    --replacement-operator x : replacement among roulette, random and ranking, default roulette
+//    --ranking-rate r : selection pressure of the ranking operators, 0 (strong) to +INFINITY (none), default 0
+//    --local-search rate : probability to improve each child with 2-opt/Or-opt moves (0 <= real <= 1)
+//    --ls-moves n   : number of 2-opt/Or-opt moves per child (0 = until a local optimum), default 50
+//    --reject-duplicates : the children already in the population are not inserted
+//    --restart-diversity d : partial restart when the edge entropy of the population falls below d (0 <= real <= 1, 0 = never)
+//    --restart-elite f : fraction of the best individuals kept by a restart, default 0.1
+//    --max-restarts k : restarts in a row without improvement before the search stops, default 3
+//    --memetic rate : probability to improve each child with Lin-Kernighan (0 <= real <= 1)
+//    --alias-batch n : roulette selection weights frozen for n generations, parents drawn in O(1) from an alias table
+//    --batch n      : children bred per step, in parallel, then inserted together (0 = steady-state GA)
+//    --threads n    : number of workers breeding a batch (0 = all cores), default 1
+//    --islands k    : number of populations evolving on their own thread (0 = all cores), default 1
+//    --topology t   : destinations of the migrants among ring, random and full, default ring
+//    --migration m  : number of generations between two migrations, default 1000
+//    --migrants n   : number of best individuals sent at each migration, default 2
+//    --seed n       : seed of the random number generator (a run with the same seed is identical with one island:
+//                     the migrants received depend on the timing of the island threads)
+//    --population n, --crossover rate, --mutation rate : replace the positional values
+//    --config file  : options tuned per instance size (written by bin/tune), the command line has priority
 {
-    // initialize the random number generator
+    // separate the named options from the positional arguments
+    Options options(argc, argv);
+    argc = options.argc();
+    argv = options.argv();
+
+    // initialize the random number generator (from --seed to reproduce a run)
+    if (options.has("seed"))
+        Random::set_seed(strtoull(options.get("seed", "0").c_str(), NULL, 10));
+    else
+        Random::set_seed(Random::clock_seed());
     Random::randomize();
 
     // default values
@@ -69,9 +108,49 @@ int main(int argc, char **argv)
         cout << "   5. name of the TSP file" << endl;
         cout << "   6. verbose (optional)" << endl;
         cout << "   7. max_duration_seconds (optional)" << endl;
+        cout << "Options (\"--name value\" or \"--name=value\", anywhere; --reject-duplicates takes no value):" << endl;
+        cout << "   --init method  : heuristic building the first individual among random, nn, greedy, sfc and savings, default random" << endl;
+        cout << "   --crossover-operator x : crossover among 1x, 2x, 2lox, pmx, eax (Edge Assembly) and adaptive, default 2x" << endl;
+        cout << "   --selection-operator x : selection among roulette, random and ranking, default roulette" << endl;
+        cout << "   --mutation-operator x : mutation among swap, random-swap, move, invert and adaptive, default invert" << endl;
+        cout << "                            (adaptive: drawn at each call, in proportion to the improvement per cycle of each operator)" << endl;
+        cout << "   --replacement-operator x : replacement among roulette, random and ranking, default roulette" << endl;
+        cout << "   --ranking-rate r : selection pressure of the ranking operators, 0 (strong) to +INFINITY (none), default 0" << endl;
+        cout << "   --local-search rate : probability to improve each child with 2-opt/Or-opt moves (0 <= real <= 1)" << endl;
+        cout << "   --ls-moves n   : number of 2-opt/Or-opt moves per child (0 = until a local optimum), default 50" << endl;
+        cout << "   --reject-duplicates : the children already in the population are not inserted" << endl;
+        cout << "   --restart-diversity d : partial restart when the edge entropy of the population falls below d (0 <= real <= 1, 0 = never)" << endl;
+        cout << "   --restart-elite f : fraction of the best individuals kept by a restart, default 0.1" << endl;
+        cout << "   --max-restarts k : restarts in a row without improvement before the search stops, default 3" << endl;
+        cout << "   --memetic rate : probability to improve each child with Lin-Kernighan (0 <= real <= 1)" << endl;
+        cout << "   --alias-batch n : roulette selection weights frozen for n generations, parents drawn in O(1) from an alias table" << endl;
+        cout << "   --batch n      : children bred per step, in parallel, then inserted together (0 = steady-state GA)" << endl;
+        cout << "   --threads n    : number of workers breeding a batch (0 = all cores), default 1" << endl;
+        cout << "   --islands k    : number of populations evolving on their own thread (0 = all cores), default 1" << endl;
+        cout << "   --topology t   : destinations of the migrants among ring, random and full, default ring" << endl;
+        cout << "   --migration m  : number of generations between two migrations, default 1000" << endl;
+        cout << "   --migrants n   : number of best individuals sent at each migration, default 2" << endl;
+        cout << "   --seed n       : seed of the random number generator (a run with the same seed is identical with one island:" << endl;
+        cout << "                    the migrants received depend on the timing of the island threads)" << endl;
+        cout << "   --population n, --crossover rate, --mutation rate : replace the positional values" << endl;
+        cout << "   --config file  : options tuned per instance size (written by bin/tune), the command line has priority" << endl;
         exit(EXIT_FAILURE);
     }
 
+    // apply the options tuned for the size of the instance
+    if (options.has("config"))
+    {
+        vector<City> cities;
+        if (!options.load_config(options.get("config", ""), "genetic", load_tsp_coordinates(tsp_file, cities)))
+        {
+            cout << "Unable to read the configuration file " << options.get("config", "") << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    population_size = options.get_int("population", population_size);
+    crossover_rate = options.get_double("crossover", crossover_rate);
+    mutation_rate = options.get_double("mutation", mutation_rate);
+
     // initialize the evolutionary algorithm
     Ae algo(num_generations, population_size, crossover_rate, mutation_rate, tsp_file, verbose, max_duration_seconds);
     // arguments of the Ae object constructor
@@ -82,13 +161,77 @@ int main(int argc, char **argv)
     //    5. TSP file
     //    6. verbose (optional)
     //    7. max_duration_seconds (optional)
+    if (!algo.set_construction(options.get("init", "random")))
+    {
+        cout << "Unknown construction heuristic: " << options.get("init", "random") << endl;
+        exit(EXIT_FAILURE);
+    }
+    // the operators are chosen once: the main loop is instantiated for each combination
+    if (!algo.set_selection_operator(options.get("selection-operator", "roulette")))
+    {
+        cout << "Unknown selection operator: " << options.get("selection-operator", "roulette") << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!algo.set_crossover_operator(options.get("crossover-operator", "2x")))
+    {
+        cout << "Unknown crossover operator: " << options.get("crossover-operator", "2x") << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!algo.set_mutation_operator(options.get("mutation-operator", "invert")))
+    {
+        cout << "Unknown mutation operator: " << options.get("mutation-operator", "invert") << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!algo.set_replacement_operator(options.get("replacement-operator", "roulette")))
+    {
+        cout << "Unknown replacement operator: " << options.get("replacement-operator", "roulette") << endl;
+        exit(EXIT_FAILURE);
+    }
+    algo.ranking_rate = options.get_double("ranking-rate", 0);
+    if (options.has("reject-duplicates"))
+        algo.pop->reject_duplicates = true;
+    if (options.has("restart-diversity"))
+        algo.set_restart(options.get_double("restart-diversity", 0), options.get_double("restart-elite", 0.1),
+                         options.get_int("max-restarts", 3));
+    if (options.has("local-search"))
+        algo.enable_local_search(options.get_double("local-search", 0), options.get_int("ls-moves", 50));
+    if (options.has("memetic"))
+        algo.enable_memetic(options.get_double("memetic", 0));
+    algo.set_alias_batch(options.get_int("alias-batch", 0));
+    int num_threads = options.get_int("threads", 1);
+    if (num_threads <= 0)
+        num_threads = max(1u, thread::hardware_concurrency());
+    // several workers without a batch size: 16 children per worker and step
+    int batch = options.get_int("batch", num_threads > 1 ? 16 * num_threads : 0);
+    if (batch > 0)
+        algo.set_batch(batch, num_threads);
 
-    cout << "Results of the Genetic algorithm for the TSP instance " << tsp_file << "\n\n";
+    cout << "Results of the Genetic algorithm for the TSP instance " << tsp_file << "\n";
+    cout << "Random seed: " << Random::seed() << "\n\n";
     
-    // run the evolutionary algorithm
-    Chromosome *best = algo.optimize();
+    // run the evolutionary algorithm, on several islands if requested
+    int num_islands = options.get_int("islands", 1);
+    if (num_islands <= 0)
+        num_islands = max(1u, thread::hardware_concurrency());
+    Topology topology;
+    if (!IslandModel::parse_topology(options.get("topology", "ring"), topology))
+    {
+        cout << "Unknown topology: " << options.get("topology", "ring") << endl;
+        exit(EXIT_FAILURE);
+    }
+    IslandModel *island_model = NULL;
+    Chromosome *best;
+    if (num_islands > 1)
+    {
+        island_model = new IslandModel(&algo, num_islands, topology,
+                                       options.get_int("migration", 1000), options.get_int("migrants", 2));
+        best = island_model->optimize();
+    }
+    else
+        best = algo.optimize();
 
     // display the fitness of the best individual found
     cout << "\nThe best solution found is: ";
     best->display();
+    delete island_model;
 }
@@ -0,0 +1,73 @@
+#include "operator_bandit.h"
+#include <algorithm>
+
+using namespace std;
+
+// initialization of a bandit over n operators
+OperatorBandit::OperatorBandit(int n, double pmin, double rate)
+{
+    size = n;
+    min_probability = pmin;
+    adaptation_rate = rate;
+    recent_gain = new double[size];
+    recent_cycles = new double[size];
+    quality = new double[size];
+    probability = new double[size];
+    calls = new long long[size];
+    cycles = new uint64_t[size];
+    improvement = new double[size];
+    for (int i = 0; i < size; i++)
+    {
+        recent_gain[i] = 0;
+        recent_cycles[i] = 0;
+        quality[i] = 0;
+        probability[i] = 1.0 / size;
+        calls[i] = 0;
+        cycles[i] = 0;
+        improvement[i] = 0;
+    }
+}
+
+// destruction of the "OperatorBandit" object
+OperatorBandit::~OperatorBandit()
+{
+    delete[] recent_gain;
+    delete[] recent_cycles;
+    delete[] quality;
+    delete[] probability;
+    delete[] calls;
+    delete[] cycles;
+    delete[] improvement;
+}
+
+// roulette over the probabilities (a handful of operators: a linear scan)
+int OperatorBandit::choose()
+{
+    double u = Random::uniform();
+    int op = 0;
+    while (op < size - 1 && u >= probability[op])
+    {
+        u -= probability[op];
+        op++;
+    }
+    calls[op]++;
+    return op;
+}
+
+// the reward is the improvement per cycle; the probabilities are matched to
+//   the qualities, above the minimum (uniform while no operator has improved)
+void OperatorBandit::reward(int op, double gain, uint64_t spent)
+{
+    cycles[op] += spent;
+    improvement[op] += gain;
+    recent_gain[op] += adaptation_rate * (gain - recent_gain[op]);
+    recent_cycles[op] += adaptation_rate * (spent - recent_cycles[op]);
+    quality[op] = recent_gain[op] / max(recent_cycles[op], 1.0);
+
+    double total = 0;
+    for (int i = 0; i < size; i++)
+        total += quality[i];
+    for (int i = 0; i < size; i++)
+        probability[i] = (total > 0) ? min_probability + (1 - size * min_probability) * quality[i] / total
+                                     : 1.0 / size;
+}
@@ -0,0 +1,58 @@
+#ifndef OPERATOR_BANDIT_H
+#define OPERATOR_BANDIT_H
+
+#include <stdint.h>
+#include <chrono>
+#include "../common/random.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BANDIT_RDTSC
+#endif
+
+// The OperatorBandit class chooses among the operators of one kind by probability
+//   matching: each operator keeps a quality, its fitness improvement per cycle of the
+//   cycle counter over its recent calls (ratio of the recency-weighted means of the
+//   improvements and of the cycles, so that a cheap operator is not credited with the
+//   huge ratio of one lucky call), and is drawn with a probability proportional to
+//   its quality, never below 'min_probability' so that an operator which paid off
+//   poorly early on is still tried. One bandit per worker.
+class OperatorBandit {
+public:
+    // ATTRIBUTES
+    int size;                // number of operators
+    double min_probability;  // lowest probability of an operator
+    double adaptation_rate;  // weight of the last call in the recency-weighted means
+    double *recent_gain;     // recency-weighted mean improvement of each operator
+    double *recent_cycles;   // recency-weighted mean cycles of each operator
+    double *quality;         // improvement per cycle of each operator, recent_gain / recent_cycles
+    double *probability;     // probability to draw each operator
+    long long *calls;        // number of times each operator was drawn
+    uint64_t *cycles;        // cycles spent in each operator
+    double *improvement;     // sum of the fitness improvements of each operator
+
+    // CONSTRUCTORS
+    OperatorBandit(int n, double min_probability = 0.02, double adaptation_rate = 0.05);
+                             // constructor of the object, all the operators equally likely
+    ~OperatorBandit();       // destructor of the object
+
+    // METHODS
+    int choose();            // draws an operator
+    void reward(int op, double gain, uint64_t spent);
+                             // credits operator 'op' with the fitness improvement 'gain' obtained in 'spent' cycles
+    static uint64_t now()    // cheap cycle counter (rdtsc, nanoseconds elsewhere)
+    {
+#ifdef BANDIT_RDTSC
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+private:
+    OperatorBandit(const OperatorBandit&);
+    OperatorBandit& operator=(const OperatorBandit&);
+};
+
+# endif
@@ -0,0 +1,141 @@
+#ifndef OPERATOR_POLICIES_H
+#define OPERATOR_POLICIES_H
+
+#include "ae.h"
+
+// The operators of the genetic algorithm as policies: Ae::evolve() is a template
+//   over one policy of each kind, so the operators of the chosen combination are
+//   called directly (and inlined) in the main loop instead of being switched on
+//   at each call. All the combinations are instantiated by Ae::strategy().
+
+// SELECTION POLICIES: select(algo, g) returns a parent for generation g
+struct RouletteSelection {
+    static Chromosome* select(Ae& algo, int) { return algo.pop->roulette_selection(); }
+};
+
+// roulette selection with the weights frozen in the alias table every 'alias_batch' generations
+struct AliasSelection {
+    static Chromosome* select(Ae& algo, int g)
+    {
+        if (g >= algo.next_freeze)
+        {
+            algo.pop->freeze_selection_weights();
+            algo.next_freeze = g + algo.alias_batch;
+        }
+        return algo.pop->alias_selection();
+    }
+};
+
+struct RandomSelection {
+    static Chromosome* select(Ae& algo, int) { return algo.pop->random_selection(); }
+};
+
+struct RankingSelection {
+    static Chromosome* select(Ae& algo, int) { return algo.pop->ranking_selection(algo.ranking_rate); }
+};
+
+// CROSSOVER POLICIES: cross(algo, parent1, parent2, child1, child2, ws) writes the genes of the children,
+//   credit(parent1, parent2, child1, child2, ws) is called once they are evaluated
+struct StaticCrossover {
+    static void credit(Chromosome*, Chromosome*, Chromosome*, Chromosome*, Workspace&) {}
+};
+
+struct OnePointCrossover : StaticCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    { algo.crossover1X(p1, p2, c1, c2, ws); }
+};
+
+struct TwoPointCrossover : StaticCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    { algo.crossover2X(p1, p2, c1, c2, ws); }
+};
+
+struct TwoPointLinearOrderCrossover : StaticCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    { algo.crossover2LOX(p1, p2, c1, c2, ws); }
+};
+
+struct PartiallyMappedCrossover : StaticCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    { algo.crossoverPMX(p1, p2, c1, c2, ws); }
+};
+
+struct EdgeAssemblyCrossover : StaticCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    { algo.crossoverEAX(p1, p2, c1, c2, ws); }
+};
+
+// the operator is drawn by the bandit of the worker, which is credited with the
+//   improvement of each child over its parent per cycle of the crossover and the evaluation
+struct AdaptiveCrossover {
+    static void cross(Ae& algo, Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    {
+        ws.crossover_arm = ws.crossover_bandit->choose();
+        ws.crossover_start = OperatorBandit::now();
+        switch (ws.crossover_arm)
+        {
+        case CROSSOVER_1X:   algo.crossover1X(p1, p2, c1, c2, ws); break;
+        case CROSSOVER_2X:   algo.crossover2X(p1, p2, c1, c2, ws); break;
+        case CROSSOVER_2LOX: algo.crossover2LOX(p1, p2, c1, c2, ws); break;
+        case CROSSOVER_PMX:  algo.crossoverPMX(p1, p2, c1, c2, ws); break;
+        default:             algo.crossoverEAX(p1, p2, c1, c2, ws); break;
+        }
+    }
+    static void credit(Chromosome* p1, Chromosome* p2, Chromosome* c1, Chromosome* c2, Workspace& ws)
+    {
+        int gain = std::max(0, p1->fitness - c1->fitness) + std::max(0, p2->fitness - c2->fitness);
+        ws.crossover_bandit->reward(ws.crossover_arm, gain, OperatorBandit::now() - ws.crossover_start);
+    }
+};
+
+// MUTATION POLICIES: mutate(algo, child, ws) changes an evaluated child and returns the variation of its fitness
+struct SwapConsecutiveMutation {
+    static int mutate(Ae& algo, Chromosome* child, Workspace&) { return child->swap_2_consecutive_genes(algo.distances); }
+};
+
+struct SwapRandomMutation {
+    static int mutate(Ae& algo, Chromosome* child, Workspace&) { return child->swap_2_random_genes(algo.distances); }
+};
+
+struct MoveMutation {
+    static int mutate(Ae& algo, Chromosome* child, Workspace&) { return child->move_1_gene(algo.distances); }
+};
+
+struct InversionMutation {
+    static int mutate(Ae& algo, Chromosome* child, Workspace&) { return child->invert_sequence_of_genes(algo.distances); }
+};
+
+// the operator is drawn by the bandit of the worker, which is credited with
+//   the decrease of the fitness per cycle of the mutation
+struct AdaptiveMutation {
+    static int mutate(Ae& algo, Chromosome* child, Workspace& ws)
+    {
+        int op = ws.mutation_bandit->choose();
+        uint64_t start = OperatorBandit::now();
+        int delta;
+        switch (op)
+        {
+        case MUTATION_SWAP:        delta = child->swap_2_consecutive_genes(algo.distances); break;
+        case MUTATION_RANDOM_SWAP: delta = child->swap_2_random_genes(algo.distances); break;
+        case MUTATION_MOVE:        delta = child->move_1_gene(algo.distances); break;
+        default:                   delta = child->invert_sequence_of_genes(algo.distances); break;
+        }
+        ws.mutation_bandit->reward(op, std::max(0, -delta), OperatorBandit::now() - start);
+        return delta;
+    }
+};
+
+// REPLACEMENT POLICIES: insert(algo, child) inserts a child in the population (which stays ranked)
+struct RouletteReplacement {
+    static void insert(Ae& algo, Chromosome* child) { algo.pop->roulette_replacement(child); }
+};
+
+struct RandomReplacement {
+    static void insert(Ae& algo, Chromosome* child) { algo.pop->random_replacement(child); }
+};
+
+struct RankingReplacement {
+    static void insert(Ae& algo, Chromosome* child) { algo.pop->ranking_replacement(child, algo.ranking_rate); }
+};
+
+# endif
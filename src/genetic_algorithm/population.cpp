@@ -1,3 +1,5 @@
+#include <stdint.h>
+#include <string.h>
 #include "population.h"
 
 using namespace std;
@@ -6,10 +8,26 @@ using namespace std;
 Population::Population(int ps, int cs)
 {
     population_size = ps;
+    // one arena for all the genes: each individual starts on a cache line (16 ints)
+    stride = (cs + 15) / 16 * 16;
+    arena = new int[(size_t)population_size * stride + 16];
+    genes = arena + (16 - (reinterpret_cast<uintptr_t>(arena) / sizeof(int)) % 16) % 16;
     individuals = new Chromosome*[population_size];
     for (int i = 0; i < population_size; i++)
-        individuals[i] = new Chromosome(cs);
+        individuals[i] = new Chromosome(cs, genes + (size_t)i * stride);
+    fitness = new int[population_size];
+    hashes = new uint64_t[population_size];
+    hash_count = new HashCount(population_size);
+    reject_duplicates = false;
+    num_duplicates = 0;
     order = new int[population_size];
+    rank = new int[population_size];
+    for (int i = 0; i < population_size; i++)
+        order[i] = rank[i] = i;
+    fitness_tree = new FenwickTree(population_size);
+    alias_table = new AliasTable(population_size);
+    frozen_weights = new double[population_size];
+    edges = NULL;
 }
 
 // destruction of the "Population" object
@@ -18,7 +36,16 @@ Population::~Population()
     for (int i = 0; i < population_size; i++)
         delete individuals[i];
     delete[] individuals;
+    delete[] arena;
+    delete[] fitness;
+    delete[] hashes;
+    delete hash_count;
     delete[] order;
+    delete[] rank;
+    delete fitness_tree;
+    delete alias_table;
+    delete[] frozen_weights;
+    delete edges;
 }
 
 // statistics about the population
@@ -29,8 +56,8 @@ void Population::statistics()
 
     for (int i = 0; i < population_size; i++)
     {
-        mean += individuals[i]->fitness;
-        standard_deviation += individuals[i]->fitness * individuals[i]->fitness;
+        mean += fitness[i];
+        standard_deviation += (double)fitness[i] * fitness[i];
     }
     mean = mean / population_size;
     standard_deviation = sqrt(standard_deviation / population_size - mean * mean);
@@ -38,124 +65,235 @@ void Population::statistics()
     cout << "fitness : (mean, standard deviation) -> ("
          << mean << " , " << standard_deviation << ")" << endl;
     cout << "fitness : [best, median, worst] -> ["
-         << individuals[order[0]]->fitness << " , "
-         << individuals[order[(int)(population_size / 2)]]->fitness << " , "
-         << individuals[order[population_size - 1]]->fitness << "]" << endl;
+         << fitness[order[0]] << " , "
+         << fitness[order[(int)(population_size / 2)]] << " , "
+         << fitness[order[population_size - 1]] << "]" << endl;
+    if (edges)
+        cout << "diversity (edge entropy, 0 when all identical) : " << diversity() << endl;
 }
 
-// Similarity of the population
+// Similarity of the population: number of copies of the three best distinct
+//   individuals, read from the histogram of the hashes
 void Population::similarity()
 {
-    int num_ind_id_1, num_ind_id_2, num_ind_id_3;
-    num_ind_id_1 = num_similar_chromosomes(individuals[order[0]]);
-    cout << "Number of identical individuals in the population with fitness = " << individuals[order[0]]->fitness << " : " << num_ind_id_1 << " / " << population_size << endl;
-    if (num_ind_id_1 < population_size)
+    uint64_t shown[3];
+    int num_shown = 0;
+    for (int r = 0; r < population_size && num_shown < 3; r++)
     {
-        num_ind_id_2 = num_similar_chromosomes(individuals[order[num_ind_id_1]]);
-        cout << "Number of identical individuals in the population with fitness = " << individuals[order[num_ind_id_1]]->fitness << " : " << num_ind_id_2 << " / " << population_size << endl;
-        if (num_ind_id_1 + num_ind_id_2 < population_size)
-        {
-            num_ind_id_3 = num_similar_chromosomes(individuals[order[num_ind_id_1 + num_ind_id_2]]);
-            cout << "Number of identical individuals in the population with fitness = " << individuals[order[num_ind_id_1 + num_ind_id_2]]->fitness << " : " << num_ind_id_3 << " / " << population_size << endl;
-        }
+        int ind = order[r];
+        if (std::find(shown, shown + num_shown, hashes[ind]) != shown + num_shown)
+            continue;
+        shown[num_shown++] = hashes[ind];
+        cout << "Number of identical individuals in the population with fitness = " << fitness[ind] << " : " << hash_count->get(hashes[ind]) << " / " << population_size << endl;
     }
+    if (reject_duplicates)
+        cout << "Duplicate children rejected: " << num_duplicates << endl;
+}
+
+// the edges are counted again by sort(), then on each replacement
+void Population::track_edges()
+{
+    if (!edges)
+        edges = new EdgeFrequency(individuals[0]->size, population_size);
+    edges->clear();
+    for (int i = 0; i < population_size; i++)
+        edges->add(individuals[i]->genes);
+}
+
+double Population::diversity()
+{
+    return edges ? edges->diversity() : 1;
+}
+
+// partial restart of a converged population: the individuals ranked after
+//   the elite get random genes, then the whole population is ranked again
+void Population::restart(int elite, int **distance)
+{
+    for (int r = max(1, elite); r < population_size; r++)
+    {
+        Chromosome* chrom = individuals[order[r]];
+        chrom->random_genes();
+        chrom->evaluate(distance);
+    }
+    sort();
 }
 
 // counts the number of similar chromosomes
 int Population::num_similar_chromosomes(Chromosome* chrom)
 {
-    int num = 0;
-    for (int i = 0; i < population_size; i++)
-        if (chrom->identical(individuals[i]))
-            num++;
-    return num;
+    return hash_count->get(chrom->hash);
+}
+
+// Order of the ranking: ascending fitness, then ascending index
+bool Population::ranked_before(int ind1, int ind2)
+{
+    if (fitness[ind1] != fitness[ind2])
+        return fitness[ind1] < fitness[ind2];
+    return ind1 < ind2;
 }
 
 // Sorts the individuals in the population in ascending order of fitness
 void Population::sort()
 {
-    int temp;
+    hash_count->clear();
     for (int i = 0; i < population_size; i++)
+    {
         order[i] = i;
-
-    for (int i = 0; i < population_size - 1; i++)
-        for (int j = i + 1; j < population_size; j++)
-            if (individuals[order[i]]->fitness > individuals[order[j]]->fitness)
-            {
-                temp = order[i];
-                order[i] = order[j];
-                order[j] = temp;
-            }
+        fitness[i] = individuals[i]->fitness;
+        hashes[i] = individuals[i]->hash;
+        hash_count->add(hashes[i]);
+    }
+    std::sort(order, order + population_size,
+              [this](int ind1, int ind2) { return ranked_before(ind1, ind2); });
+    if (edges)
+        track_edges();
+    for (int i = 0; i < population_size; i++)
+    {
+        rank[order[i]] = i;
+        fitness_tree->set(i, fitness[i]);
+    }
 }
 
-// Re-sorts the ranking of individuals in the population in ascending order of fitness
-//   after a small change
-void Population::resort()
+// Repairs the ranking after the fitness of one individual has changed:
+//   its new rank is found by binary search among the individuals it passes,
+//   and the individuals in between are shifted by one rank
+void Population::update(int ind)
 {
-    int temp;
-    for (int i = 0; i < population_size - 1; i++)
-        for (int j = i + 1; j < population_size; j++)
-            if (individuals[order[i]]->fitness > individuals[order[j]]->fitness)
-            {
-                temp = order[i];
-                order[i] = order[j];
-                order[j] = temp;
-            }
+    fitness[ind] = individuals[ind]->fitness;
+    fitness_tree->set(ind, fitness[ind]);
+    if (hashes[ind] != individuals[ind]->hash)
+    {
+        hash_count->remove(hashes[ind]);
+        hashes[ind] = individuals[ind]->hash;
+        hash_count->add(hashes[ind]);
+    }
+
+    int r = rank[ind];
+    int new_rank;
+    auto before = [this](int ind1, int ind2) { return ranked_before(ind1, ind2); };
+
+    if (r > 0 && ranked_before(ind, order[r - 1]))
+    {
+        // better than before: shift the individuals of ranks new_rank..r-1 down
+        new_rank = lower_bound(order, order + r, ind, before) - order;
+        for (int i = r; i > new_rank; i--)
+        {
+            order[i] = order[i - 1];
+            rank[order[i]] = i;
+        }
+    }
+    else if (r < population_size - 1 && ranked_before(order[r + 1], ind))
+    {
+        // worse than before: shift the individuals of ranks r+1..new_rank up
+        new_rank = lower_bound(order + r + 1, order + population_size, ind, before) - order - 1;
+        for (int i = r; i < new_rank; i++)
+        {
+            order[i] = order[i + 1];
+            rank[order[i]] = i;
+        }
+    }
+    else
+        return;
+    order[new_rank] = ind;
+    rank[ind] = new_rank;
 }
 
 // BIASED ROULETTE SELECTION
-// selection operator based on the fitness function
+// selection operator based on the fitness function: the weight of an individual
+//   is its margin to the worst fitness, drawn from the fitness tree in O(log p)
 Chromosome* Population::roulette_selection()
 {
-    int fitness_sum = individuals[0]->fitness;
-    int fitness_max = individuals[0]->fitness;
-    int portion_sum;
+    long long fitness_max = fitness[order[population_size - 1]];
+    long long portion_sum = fitness_max * population_size - fitness_tree->total();
 
-    for (int i = 1; i < population_size; i++)
-    {
-        fitness_sum += individuals[i]->fitness;
-        if (fitness_max < individuals[i]->fitness)
-            fitness_max = individuals[i]->fitness;
-    }
-    portion_sum = fitness_max * population_size - fitness_sum;
+    // all the individuals have the same fitness
+    if (portion_sum <= 0)
+        return individuals[Random::random(population_size)];
 
-    double random_variable = Random::random(1000) / 1000.0;
+    double random_variable = Random::uniform();
+    return individuals[fitness_tree->find(random_variable * portion_sum, fitness_max, -1)];
+}
 
-    int ind = 0;
-    double portion = (fitness_max - individuals[0]->fitness) * 1.0 / portion_sum;
-    while ((ind < population_size - 1) && (random_variable >= portion))
+// biased roulette replacement operator for an individual in the population
+//   with a new given individual: the weight of an individual is its fitness,
+//   and the best individual is left out of the draw
+void Population::roulette_replacement(Chromosome* individual)
+{
+    if (rejected(individual))
+        return;
+    int best = order[0];
+    fitness_tree->set(best, 0);
+    long long fitness_sum = fitness_tree->total();
+
+    int ind = order[population_size - 1];
+    if (fitness_sum > 0)
     {
-        ind++;
-        portion += (fitness_max - individuals[ind]->fitness) * 1.0 / portion_sum;
+        double random_variable = Random::uniform();
+        ind = fitness_tree->find(random_variable * fitness_sum, 0, 1);
     }
-    return individuals[ind];
+    fitness_tree->set(best, fitness[best]);
+
+    replace(ind, individual);
 }
 
-// biased roulette replacement operator for an individual in the population
-//   with a new given individual
-void Population::roulette_replacement(Chromosome* individual)
+// freezes the weights of the roulette selection (margin to the worst fitness)
+//   in the alias table, for a batch of selections in O(1)
+void Population::freeze_selection_weights()
 {
-    int fitness_sum = individuals[0]->fitness;
-    for (int i = 1; i < population_size; i++)
-        fitness_sum += individuals[i]->fitness;
+    int fitness_max = fitness[order[population_size - 1]];
+    int fitness_min = fitness[order[0]];
+    for (int i = 0; i < population_size; i++)
+        // all the individuals have the same fitness: uniform weights
+        frozen_weights[i] = (fitness_max > fitness_min) ? fitness_max - fitness[i] : 1;
+    alias_table->build(frozen_weights);
+}
 
-    double random_variable;
-    int ind = order[0];
-    double portion;
+// roulette selection with the weights frozen by freeze_selection_weights()
+Chromosome* Population::alias_selection()
+{
+    return individuals[alias_table->sample()];
+}
 
-    while (order[0] == ind)
+// copies the genes, the fitness and the hash of 'individual' in the slot of individual 'ind'
+void Population::replace(int ind, Chromosome* individual)
+{
+    if (edges)
     {
-        random_variable = Random::random(1000) / 1000.0;
-        ind = 0;
-        portion = individuals[0]->fitness * 1.0 / fitness_sum;
-        while ((ind < population_size - 1) && (random_variable > portion))
-        {
-            ind++;
-            portion += individuals[ind]->fitness * 1.0 / fitness_sum;
-        }
+        edges->remove(genes + (size_t)ind * stride);
+        edges->add(individual->genes);
     }
-    individuals[ind]->copy(individual);
+    memcpy(genes + (size_t)ind * stride, individual->genes, individual->size * sizeof(int));
     individuals[ind]->fitness = individual->fitness;
+    individuals[ind]->hash = individual->hash;
+    update(ind);
+}
+
+// replacement of the worst individual in the population with a given
+//   individual, if it is better and not already in the population (migrations)
+void Population::worst_replacement(Chromosome* individual)
+{
+    int worst = order[population_size - 1];
+    if (individual->fitness >= fitness[worst] || contains(individual))
+        return;
+    replace(worst, individual);
+}
+
+// the hash of a cycle does not depend on its first gene nor on its orientation:
+//   an individual is the same cycle if it has the same hash (collisions of
+//   64-bit hashes are neglected)
+bool Population::contains(Chromosome* chrom)
+{
+    return hash_count->get(chrom->hash) > 0;
+}
+
+// a child already in the population is rejected, so that the copies of the
+//   best individuals do not take over the population
+bool Population::rejected(Chromosome* chrom)
+{
+    if (!reject_duplicates || !contains(chrom))
+        return false;
+    num_duplicates++;
+    return true;
 }
 
 // RANDOM SELECTION
@@ -170,9 +308,10 @@ Chromosome* Population::random_selection()
 //   with a new given individual
 void Population::random_replacement(Chromosome* individual)
 {
+    if (rejected(individual))
+        return;
     int random_ind = Random::random(population_size);
-    individuals[random_ind]->copy(individual);
-    individuals[random_ind]->fitness = individual->fitness;
+    replace(random_ind, individual);
 }
 
 // RANKING SELECTION
@@ -182,9 +321,7 @@ void Population::random_replacement(Chromosome* individual)
 //   0 strong pressure and +INFINITY weak pressure (probability = 1/nb regardless of the individual)
 Chromosome* Population::ranking_selection(float ranking_rate)
 {
-    resort();
-
-    double random_variable = Random::random(10000) / 10000.0;
+    double random_variable = Random::uniform();
     int num = population_size;
     int i = 0;
     ranking_rate = ranking_rate / 100;
@@ -206,7 +343,9 @@ Chromosome* Population::ranking_selection(float ranking_rate)
 //   with a new given individual
 void Population::ranking_replacement(Chromosome* individual, float ranking_rate)
 {
-    double random_variable = Random::random(10000) / 10000.0;
+    if (rejected(individual))
+        return;
+    double random_variable = Random::uniform();
     int T = population_size;
     int i = 0;
     ranking_rate = ranking_rate / 100;
@@ -219,9 +358,7 @@ void Population::ranking_replacement(Chromosome* individual, float ranking_rate)
     }
     if (i >= T)
         i = Random::random(T);
-    int ind = order[i];
-    individuals[ind]->copy(individual);
-    individuals[ind]->fitness = individual->fitness;
+    replace(order[i], individual);
 }
 
 // displays the population, its rank, and its fitness
@@ -230,7 +367,7 @@ void Population::display()
     cout << "Population of " << population_size << " individuals :" << endl;
     for (int i = 0; i < population_size; i++)
     {
-        cout << "individual " << i << ", rank: " << order[i] << " ";
+        cout << "individual " << i << ", rank: " << rank[i] << " ";
         individuals[i]->display();
     }
 }
@@ -4,16 +4,34 @@
 #include <math.h>
 #include <stdio.h>
 #include <iostream>
+#include <algorithm>
 #include "chromosome.h"
+#include "fenwick_tree.h"
+#include "alias_table.h"
+#include "edge_frequency.h"
+#include "hash_count.h"
 
 // The Population class encompasses multiple potential solutions to the problem
 class Population {
 public:
     // ATTRIBUTES
-    Chromosome **individuals; // list of individuals in the population
+    Chromosome **individuals; // list of individuals in the population: views on the arena
     int population_size;      // number of individuals in the population
+    int *arena;               // allocation of the genes of all the individuals
+    int *genes;               // genes of individual i at genes[i * stride], aligned on a cache line
+    int stride;               // number of genes rounded up to a whole number of cache lines
+    int *fitness;             // fitness of each individual, copied from the view by sort() and update()
+    uint64_t *hashes;         // hash of each individual, copied from the view by sort() and update()
+    HashCount *hash_count;    // number of individuals of each hash
+    bool reject_duplicates;   // true to reject the children already in the population
+    long long num_duplicates; // number of children rejected as duplicates
     int *order;               // array giving the order of individuals in the population
-                              // from best to worst based on fitness
+                              // from best to worst based on fitness (ties by index)
+    int *rank;                // position of each individual in 'order'
+    FenwickTree *fitness_tree; // fitness of the individuals, drawn from by the roulette operators
+    AliasTable *alias_table;  // roulette selection weights frozen by freeze_selection_weights()
+    double *frozen_weights;   // scratch of freeze_selection_weights()
+    EdgeFrequency *edges;     // counts of the edges of the individuals, NULL unless tracked
 
     // CONSTRUCTORS
     Population(int ps, int cs); // constructor of the object
@@ -22,22 +40,35 @@ public:
     // METHODS
     void statistics(); // displays some statistics about the population
     int num_similar_chromosomes(Chromosome* chrom);
-                        // counts the number of chromosomes similar to 'chrom'
-    void similarity();  // displays the results of counting similar chromosomes
-                        // to the best individuals in the population.
+                        // counts the number of chromosomes similar to 'chrom', in O(1)
+    void similarity();  // displays the number of copies of the best distinct
+                        // individuals in the population (histogram of the hashes)
+    void track_edges(); // counts the edges of the individuals from now on
+    double diversity(); // edge entropy of the population, from 0 (all identical) to 1, in O(1)
+    void restart(int elite, int **distance);
+                        // keeps the 'elite' best individuals and draws the others again
 
     // SELECTION AND REPLACEMENT OPERATORS
     Chromosome *roulette_selection();                 // biased roulette selection of an individual from the population
     void roulette_replacement(Chromosome *individual); // biased roulette replacement of an individual in the population with a given chromosome
 
+    void freeze_selection_weights();                  // freezes the weights of the roulette selection in the alias table
+    Chromosome *alias_selection();                    // roulette selection with the frozen weights, in O(1)
+
     Chromosome *ranking_selection(float ranking_rate); // ranking selection of an individual from the population
     void ranking_replacement(Chromosome *individual, float ranking_rate); // ranking replacement of an individual in the population with a given chromosome
 
+    void replace(int ind, Chromosome* individual);   // copies 'individual' in the slot of individual 'ind'
+    void worst_replacement(Chromosome* individual);  // replaces the worst individual if 'individual' is better and new
+    bool contains(Chromosome* chrom);                // true if an individual is the same cycle as 'chrom', in O(1)
+    bool rejected(Chromosome* chrom);                // true if 'chrom' is a duplicate to reject
+
     Chromosome* random_selection();                // random selection and replacement
     void random_replacement(Chromosome* individual); // random replacement
 
-    void sort();
-    void resort();
+    void sort();          // sorts the whole population, after the initial evaluation
+    void update(int ind); // moves individual 'ind' to its rank after a change of its fitness
+    bool ranked_before(int ind1, int ind2); // true if 'ind1' is ranked before 'ind2'
     void display();
 };
 
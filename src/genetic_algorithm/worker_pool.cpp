@@ -0,0 +1,74 @@
+#include "worker_pool.h"
+#include "../common/random.h"
+
+using namespace std;
+
+// starts the workers 1..num_workers-1
+WorkerPool::WorkerPool(int num_workers, unsigned stream)
+{
+    size = num_workers < 1 ? 1 : num_workers;
+    first_stream = stream;
+    job = NULL;
+    generation = 0;
+    pending = 0;
+    stop = false;
+    for (int k = 1; k < size; k++)
+        threads.push_back(thread(&WorkerPool::loop, this, k));
+}
+
+// stops and joins the threads
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    started.notify_all();
+    for (size_t k = 0; k < threads.size(); k++)
+        threads[k].join();
+}
+
+// the calling thread runs the job as worker 0, then waits for the others
+void WorkerPool::run(const function<void(int)>& task)
+{
+    if (size > 1)
+    {
+        lock_guard<mutex> guard(lock);
+        job = &task;
+        pending = size - 1;
+        generation++;
+    }
+    started.notify_all();
+    task(0);
+    if (size > 1)
+    {
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [this]() { return pending == 0; });
+        job = NULL;
+    }
+}
+
+// waits for each new job and runs it
+void WorkerPool::loop(int worker)
+{
+    Random::randomize(first_stream + worker);
+    int done = 0;
+    while (true)
+    {
+        const function<void(int)>* task;
+        {
+            unique_lock<mutex> guard(lock);
+            started.wait(guard, [this, done]() { return stop || generation != done; });
+            if (stop)
+                return;
+            done = generation;
+            task = job;
+        }
+        (*task)(worker);
+        {
+            lock_guard<mutex> guard(lock);
+            pending--;
+        }
+        finished.notify_one();
+    }
+}
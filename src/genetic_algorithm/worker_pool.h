@@ -0,0 +1,42 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The WorkerPool class runs the same job on a fixed set of workers and waits
+//   for all of them: worker 0 is the calling thread, workers 1..size-1 are
+//   threads started once, so a job costs two synchronizations and no thread creation.
+//   Worker k draws its random numbers from the stream first_stream + k of the seed
+//   (the calling thread is expected to use first_stream already).
+class WorkerPool {
+public:
+    // ATTRIBUTES
+    int size;                         // number of workers, the calling thread included
+    unsigned first_stream;            // random stream of worker 0
+
+    // CONSTRUCTORS
+    WorkerPool(int num_workers, unsigned first_stream = 0);
+                                      // constructor of the object, starts num_workers - 1 threads
+    ~WorkerPool();                    // destructor of the object, stops the threads
+
+    // METHODS
+    void run(const std::function<void(int)>& job); // runs job(k) on every worker k and waits for them
+
+private:
+    std::vector<std::thread> threads; // workers 1..size-1
+    std::mutex lock;                  // protects the fields below
+    std::condition_variable started;  // signals a new job or the stop
+    std::condition_variable finished; // signals the end of the job of a worker
+    const std::function<void(int)>* job; // job in progress
+    int generation;                   // number of jobs submitted
+    int pending;                      // workers still running the current job
+    bool stop;                        // true when the threads must exit
+
+    void loop(int worker);            // main loop of a thread
+};
+
+# endif
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include <fstream>
 #include <vector>
 #include <cmath>
@@ -12,6 +13,9 @@
 #include <mutex>
 #include "utils.h"
 #include "thread_pool.h"
+#include "../common/lin_kernighan.h"
+#include "../common/options.h"
+#include "../common/construction.h"
 
 using namespace std;
 
@@ -112,33 +116,25 @@ double evaluation_solution(const vector<int>& sol) {
 }
 
 /**
- * @brief Compute an initial solution based on the nearest neighbor heuristic
- * 
+ * @brief Compute an initial solution with a construction heuristic
+ * (nearest neighbour from town 0 by default, see Construction)
+ *
+ * @param method construction heuristic
  * @return evaluation of the initial solution
  */
-double initial_solution() {
+double initial_solution(Construction::Method method) {
     size_t nbr_towns = coordinates.size();
     vector<int> sol(nbr_towns);
     double eval = 0;
-    vector<int> visited(nbr_towns, 0);
-    int current_town = 0;
-    visited[current_town] = 1;
-    sol[0] = current_town;
-
-    for (size_t i = 1; i < nbr_towns; ++i) {
-        int next_town = -1;
-        double min_dist = -1.0;
-        for (size_t j = 0; j < nbr_towns; ++j) {
-            if (visited[j] == 0 && (min_dist < 0 || dist[current_town][j] < min_dist)) {
-                next_town = j;
-                min_dist = dist[current_town][j];
-            }
-        }
-        sol[i] = next_town;
-        visited[next_town] = 1;
-        current_town = next_town;
-        eval += min_dist;
+
+    vector<City> cities(nbr_towns);
+    vector<const double*> rows(nbr_towns);
+    for (size_t i = 0; i < nbr_towns; ++i) {
+        cities[i].x = coordinates[i].first;
+        cities[i].y = coordinates[i].second;
+        rows[i] = dist[i].data();
     }
+    Construction::build(method, cities, rows.data(), sol.data(), 0);
 
     eval = evaluation_solution(sol);
     cout << "Initial solution ";
@@ -150,6 +146,30 @@ double initial_solution() {
     return eval;
 }
 
+/**
+ * @brief Improve the incumbent solution with Lin-Kernighan, so that the
+ * branch and bound starts with a tighter cutoff
+ *
+ * @return evaluation of the improved incumbent
+ */
+double polish_incumbent() {
+    size_t nbr_towns = coordinates.size();
+    vector<const double*> rows(nbr_towns);
+    for (size_t i = 0; i < nbr_towns; ++i) {
+        rows[i] = dist[i].data();
+    }
+    LinKernighan<double> lin_kernighan(rows.data(), nbr_towns);
+    lin_kernighan.optimize(best_solution.data());
+    // Lin-Kernighan rotates the tour: start it again from town 0, as every printed tour
+    rotate(best_solution.begin(), find(best_solution.begin(), best_solution.end(), 0), best_solution.end());
+
+    best_eval = evaluation_solution(best_solution);
+    cout << "Incumbent improved by Lin-Kernighan ";
+    print_solution(best_solution, best_eval);
+
+    return best_eval;
+}
+
 /**
  * @brief Build a final solution
  * 
@@ -452,12 +472,21 @@ void load_tsp_file(const string& file_path) {
  * @brief Main function
  * 
  * @param argc number of arguments
- * @param argv arguments
+ * @param argv arguments, named options ("--name value" or "--name=value") may be given anywhere,
+ *             the flag --lk takes no value
  * @return int return code
  */
 int main(int argc, char* argv[]) {
+    // Separate the named options from the positional arguments
+    Options options(argc, argv);
+    argc = options.argc();
+    argv = options.argv();
+
     if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " <tsp_instance_name> [verbose] [max_duration_seconds]\n";
+        cerr << "Usage: " << argv[0] << " <tsp_instance_name> [verbose] [max_duration_seconds] [--lk] [--init method]\n";
+        cerr << "Options (\"--name value\" or \"--name=value\", anywhere; --lk takes no value):\n";
+        cerr << "  --lk : improve the initial solution with Lin-Kernighan before the branch and bound\n";
+        cerr << "  --init method : heuristic of the initial solution among random, nn, greedy, sfc and savings, default nn\n";
         cerr << "Without using the script, the tsp_instance_name must be the path to the TSP file with the .tsp extension\n";
         return 1;
     }
@@ -487,7 +516,18 @@ int main(int argc, char* argv[]) {
         cout << "\n";
     }
 
-    double initial_value = initial_solution();
+    // the random construction draws from the clock
+    Random::set_seed(Random::clock_seed());
+    Random::randomize();
+    Construction::Method construction;
+    if (!Construction::parse(options.get("init", "nn"), construction)) {
+        cerr << "Unknown construction heuristic: " << options.get("init", "nn") << "\n";
+        return 1;
+    }
+    double initial_value = initial_solution(construction);
+    if (options.has("lk")) {
+        initial_value = polish_incumbent();
+    }
     little_algorithm(dist, 0, 0.0, next_town);
 
     // Wait for all threads to finish
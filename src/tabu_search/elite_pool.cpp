@@ -0,0 +1,59 @@
+#include <algorithm>
+#include "elite_pool.h"
+
+using namespace std;
+
+ElitePool::ElitePool(int capacity) : capacity(max(1, capacity)) {
+}
+
+bool ElitePool::publish(const Solution& sol) {
+    lock_guard<mutex> guard(lock);
+    int count = (int)fitnesses.size();
+    if (count == capacity && sol.fitness >= fitnesses[count - 1])
+        return false;
+    // Rank of the solution, after the solutions of equal fitness
+    int rank = 0;
+    while (rank < count && fitnesses[rank] <= sol.fitness) {
+        // Solutions are ordered, so identical tours have identical arrays
+        if (fitnesses[rank] == sol.fitness && equal(tours[rank].begin(), tours[rank].end(), sol.city))
+            return false;
+        rank++;
+    }
+    if (count == capacity) {
+        tours.pop_back();
+        fitnesses.pop_back();
+    }
+    tours.insert(tours.begin() + rank, vector<int>(sol.city, sol.city + sol.size));
+    fitnesses.insert(fitnesses.begin() + rank, sol.fitness);
+    return true;
+}
+
+bool ElitePool::sample(Solution& sol) {
+    lock_guard<mutex> guard(lock);
+    if (fitnesses.empty())
+        return false;
+    copy(Random::random(fitnesses.size()), sol);
+    return true;
+}
+
+bool ElitePool::best(Solution& sol) {
+    lock_guard<mutex> guard(lock);
+    if (fitnesses.empty())
+        return false;
+    copy(0, sol);
+    return true;
+}
+
+int ElitePool::size() {
+    lock_guard<mutex> guard(lock);
+    return (int)fitnesses.size();
+}
+
+/**
+ * Copies the k-th solution of the pool. The lock must be held.
+ */
+void ElitePool::copy(int k, Solution& sol) {
+    for (int i = 0; i < sol.size; i++)
+        sol.city[i] = tours[k][i];
+    sol.fitness = fitnesses[k];
+}
@@ -0,0 +1,59 @@
+#ifndef _ELITE_POOL_H
+#define _ELITE_POOL_H
+
+#include <mutex>
+#include <vector>
+#include "solution.h"
+
+using namespace std;
+
+/**
+ * The ElitePool class keeps the best distinct solutions published by the
+ * threads of a parallel Tabu Search. All the methods lock the pool, so it
+ * can be shared by the threads without further synchronization.
+ */
+class ElitePool {
+    public:
+        /**
+         * Constructor
+         * @param capacity Maximum number of solutions kept
+         */
+        ElitePool(int capacity);
+
+        /**
+         * Adds a copy of a solution if it is better than the worst one kept
+         * and not already in the pool.
+         * @param sol Ordered and evaluated solution
+         * @return true if the solution was added
+         */
+        bool publish(const Solution& sol);
+
+        /**
+         * Copies a solution of the pool drawn at random (with the generator of the calling thread).
+         * @param sol Solution receiving the copy, with its fitness
+         * @return false if the pool is empty
+         */
+        bool sample(Solution& sol);
+
+        /**
+         * Copies the best solution of the pool.
+         * @param sol Solution receiving the copy, with its fitness
+         * @return false if the pool is empty
+         */
+        bool best(Solution& sol);
+
+        /**
+         * @return Number of solutions in the pool
+         */
+        int size();
+
+    private:
+        int capacity;                   ///< Maximum number of solutions kept
+        vector<vector<int> > tours;     ///< Cities of the solutions, best first
+        vector<int> fitnesses;          ///< Fitness of the solutions, in increasing order
+        mutex lock;                     ///< Protects tours and fitnesses
+
+        void copy(int k, Solution& sol);
+};
+
+#endif
@@ -3,12 +3,100 @@
 #include <cmath>
 #include <cstring>
 #include <cstdio>
-#include "random.h"
+#include <thread>
+#include <vector>
+#include "../common/random.h"
 #include "tabu_search.h"
 #include "solution.h"
+#include "elite_pool.h"
+#include "../common/options.h"
 
 using namespace std;
 
+/**
+ * Applies the named options to a search.
+ * @param start Start city of the nearest neighbour initial solution
+ * @return false if an option is invalid
+ */
+bool configure(TabuSearch& algo, const Options& options, int start) {
+    if (!algo.setConstruction(options.get("init", "random"), start)) {
+        cout << "Unknown construction heuristic: " << options.get("init", "random") << endl;
+        return false;
+    }
+    if (options.has("candidates"))
+        algo.setNumCandidates(options.get_int("candidates", 10));
+    if (!algo.setNeighborhoods(options.get("neighborhood", "swap"))) {
+        cout << "Unknown neighborhood: " << options.get("neighborhood", "swap") << endl;
+        return false;
+    }
+    algo.setLinKernighan(options.has("lk"));
+    if (!algo.setIteratedLocalSearch(options.get("ils", "none"), options.get_int("kick", 50))) {
+        cout << "Unknown acceptance criterion: " << options.get("ils", "none") << endl;
+        return false;
+    }
+    if (options.has("no-simd"))
+        algo.setSimd(false);
+    if (options.has("stagnation"))
+        algo.setMaxNoImprovementIterations(options.get_int("stagnation", 50));
+    if (options.has("perturbation"))
+        algo.setNumPerturbationsDenominator(options.get_int("perturbation", 6));
+    algo.setReactive(options.has("reactive"));
+    if (options.has("tenure-trace"))
+        algo.enableTenureTrace();
+    return true;
+}
+
+/**
+ * Runs independent searches in parallel, one per thread, sharing their best
+ * solutions through an elite pool, and displays the best solution found.
+ */
+void optimize_parallel(int num_threads, int num_iterations, int tabu_length, const char* tspFile,
+                       int verbose, int max_duration_seconds, const Options& options) {
+    ElitePool elite_pool(options.get_int("elite", 8));
+    vector<TabuSearch*> searches;
+    for (int k = 0; k < num_threads; k++) {
+        // Only the first thread reports its iterations
+        int thread_verbose = (k == 0) ? verbose : 0;
+        if (k == 0)
+            searches.push_back(new TabuSearch(num_iterations, tabu_length, tspFile, thread_verbose, max_duration_seconds));
+        else
+            searches.push_back(new TabuSearch(num_iterations, tabu_length, *searches[0], thread_verbose, max_duration_seconds));
+        // each thread starts its nearest neighbour tour from a different city
+        if (!configure(*searches[k], options, k % searches[k]->solution_size))
+            exit(EXIT_FAILURE);
+        searches[k]->setElitePool(&elite_pool, options.get_int("publish", 100), options.get_int("restart", 3));
+    }
+
+    vector<Solution*> bests(num_threads);
+    vector<thread> threads;
+    for (int k = 0; k < num_threads; k++) {
+        threads.push_back(thread([k, &searches, &bests]() {
+            Random::randomize(k + 1);
+            bests[k] = searches[k]->optimize();
+        }));
+    }
+    for (int k = 0; k < num_threads; k++)
+        threads[k].join();
+
+    int best_thread = 0;
+    cout << endl;
+    for (int k = 0; k < num_threads; k++) {
+        cout << "Best solution of thread " << k << ": " << bests[k]->fitness << " km" << endl;
+        if (bests[k]->fitness < bests[best_thread]->fitness)
+            best_thread = k;
+    }
+    cout << endl << "The best solution found is: ";
+    bests[best_thread]->display();
+    if (options.has("tenure-trace") && !searches[0]->writeTenureTrace(options.get("tenure-trace", "")))
+        cout << "Unable to write the file " << options.get("tenure-trace", "") << endl;
+
+    // The first search owns the distance matrix: delete it last
+    for (int k = num_threads - 1; k >= 0; k--) {
+        delete bests[k];
+        delete searches[k];
+    }
+}
+
 /**
  * Main function to execute the Tabu Search algorithm for solving the TSP.
  * 
@@ -19,9 +107,20 @@ using namespace std;
  *   2. length of the Tabu list
  *   3. number of cities
  *   4. filename indicating the distances between cities
+ * Named options ("--name value" or "--name=value") may be given anywhere after the executable name;
+ * the flags (--lk, --no-simd, --reactive) take no value.
  */
 int main(int argc, char **argv) {
-    // Initialize the random number generator
+    // Separate the named options from the positional arguments
+    Options options(argc, argv);
+    argc = options.argc();
+    argv = options.argv();
+
+    // Initialize the random number generator (from --seed to reproduce a run)
+    if (options.has("seed"))
+        Random::set_seed(strtoull(options.get("seed", "0").c_str(), NULL, 10));
+    else
+        Random::set_seed(Random::clock_seed());
     Random::randomize();
 
     // Default values
@@ -38,6 +137,27 @@ int main(int argc, char **argv) {
     cout << "   3. tsp_file      : TSP file containing the coordinates of cities, default value = " << tspFile << endl;
     cout << "   4. verbose             : verbose output, default value = " << verbose << endl;
     cout << "   5. max_duration_seconds: maximum duration in seconds, default value = " << max_duration_seconds << endl;
+    cout << "Options (\"--name value\" or \"--name=value\", anywhere; --lk, --no-simd and --reactive take no value):" << endl;
+    cout << "   --neighborhood list : neighbourhoods among swap, 2opt, oropt, 3opt, all (comma separated), default value = swap" << endl;
+    cout << "   --candidates k      : size of the candidate lists used by oropt and 3opt, default value = 10" << endl;
+    cout << "   --init method       : initial solution among random, nn (nearest neighbour), greedy, sfc (space-filling curve)" << endl;
+    cout << "                         and savings, default value = random" << endl;
+    cout << "   --lk                : improve each perturbed solution with Lin-Kernighan" << endl;
+    cout << "   --ils criterion     : iterated local search (double-bridge kicks repaired by Lin-Kernighan) instead of the tabu search," << endl;
+    cout << "                         accepting the new local optimum if better, always (walk) or by annealing (anneal)" << endl;
+    cout << "   --kick n            : maximum length of the paths exchanged by a kick of the iterated local search, default value = 50" << endl;
+    cout << "   --no-simd           : evaluates swap and 2opt with the scalar loops instead of the AVX2 kernels" << endl;
+    cout << "   --tabu-length n     : tabu list length, replaces the positional value" << endl;
+    cout << "   --stagnation n      : iterations without improvement before a perturbation, default value = 50" << endl;
+    cout << "   --perturbation d    : a perturbation swaps number_cities / d pairs of cities, default value = 6" << endl;
+    cout << "   --reactive          : the tabu length grows when the search cycles and shrinks otherwise (tabu_length = initial value)" << endl;
+    cout << "   --tenure-trace file : writes the changes of the tabu length of the reactive search (first thread)" << endl;
+    cout << "   --config file       : options tuned per instance size (written by bin/tune), the command line has priority" << endl;
+    cout << "   --seed n            : seed of the random number generator, default value = taken from the clock" << endl;
+    cout << "   --threads n         : number of parallel searches sharing an elite pool (0 = all cores), default value = 1" << endl;
+    cout << "   --elite n           : size of the elite pool, default value = 8" << endl;
+    cout << "   --publish n         : iterations between two publications to the elite pool, default value = 100" << endl;
+    cout << "   --restart n         : perturbations without improvement before restarting from the elite pool, default value = 3" << endl;
     cout << endl;
 
     if (argc >= 4) {
@@ -58,19 +178,43 @@ int main(int argc, char **argv) {
         cout << "Incorrect arguments" << endl;
         exit(EXIT_FAILURE);
     }
-    cout << "Results of the Tabu Search algorithm for the TSP instance " << tspFile << "\n\n";
+    // Apply the options tuned for the size of the instance
+    if (options.has("config")) {
+        vector<City> cities;
+        if (!options.load_config(options.get("config", ""), "tabu", load_tsp_coordinates(tspFile, cities))) {
+            cout << "Unable to read the configuration file " << options.get("config", "") << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    tabu_length = options.get_int("tabu-length", tabu_length);
+
+    cout << "Results of the Tabu Search algorithm for the TSP instance " << tspFile << "\n";
+    cout << "Random seed: " << Random::seed() << "\n\n";
+
+    int num_threads = options.get_int("threads", 1);
+    if (num_threads <= 0)
+        num_threads = max(1u, thread::hardware_concurrency());
+    if (num_threads > 1) {
+        optimize_parallel(num_threads, num_iterations, tabu_length, tspFile, verbose, max_duration_seconds, options);
+        return 0;
+    }
+
     // Initialize the parameters of the TabuSearch and create the initial solution
     //   1st parameter: number of iterations (stopping criterion of the algorithm)
     //   2nd parameter: length of the Tabu list
     //   3rd parameter: number of cities
     //   4th parameter: file containing the distances between cities    
     TabuSearch algo(num_iterations, tabu_length, tspFile, verbose, max_duration_seconds);
+    if (!configure(algo, options, 0))
+        exit(EXIT_FAILURE);
 
     // Run the search with the Tabu method
     Solution* best = algo.optimize();
     // Display the best solution found
     cout << endl << "The best solution found is: ";
     best->display();
+    if (options.has("tenure-trace") && !algo.writeTenureTrace(options.get("tenure-trace", "")))
+        cout << "Unable to write the file " << options.get("tenure-trace", "") << endl;
 
     delete best;
 
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include "../common/random.h"
+#include "tabu_search.h"
+#include "../common/options.h"
+
+using namespace std;
+
+/**
+ * Evaluates a neighbourhood on the same random solutions with the scalar loops
+ * and with the AVX2 kernels, checks that both select the same move and
+ * displays the number of moves evaluated per second.
+ *
+ * @param algo Search on the instance
+ * @param neighborhood Name of the neighbourhood (swap or 2opt)
+ * @param num_solutions Number of random solutions evaluated
+ * @return false if the two versions selected different moves
+ */
+bool benchmark(TabuSearch& algo, const string& neighborhood, int num_solutions) {
+    int n = algo.solution_size;
+    double moves = (double)num_solutions * n * (n - 1) / 2;
+    double seconds[2] = { 0, 0 };
+    int mismatches = 0;
+    algo.setNeighborhoods(neighborhood);
+    algo.setNumPerturbationsDenominator(1);
+
+    for (int s = 0; s < num_solutions; s++) {
+        algo.perturb_solution();
+        Move selected[2];
+        for (int simd = 0; simd < 2; simd++) {
+            algo.setSimd(simd == 1);
+            auto start = chrono::high_resolution_clock::now();
+            algo.selectMove(selected[simd]);
+            seconds[simd] += chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        }
+        if (selected[0].type != selected[1].type || selected[0].a != selected[1].a
+            || selected[0].b != selected[1].b || selected[0].delta != selected[1].delta)
+            mismatches++;
+    }
+
+    cout << neighborhood << ":" << endl;
+    cout << "   scalar : " << moves / seconds[0] / 1e6 << " million moves/s" << endl;
+    if (TabuSearch::simdSupported())
+        cout << "   AVX2   : " << moves / seconds[1] / 1e6 << " million moves/s (x" << seconds[0] / seconds[1] << ")" << endl;
+    else
+        cout << "   AVX2   : not supported by this processor" << endl;
+    if (mismatches > 0)
+        cout << "   " << mismatches << " different moves selected" << endl;
+    return mismatches == 0;
+}
+
+/**
+ * Microbenchmark of the swap and 2-opt neighbourhoods of the Tabu Search.
+ *
+ * @param argc number of parameters
+ * @param argv array containing the parameters
+ *   1. TSP file, default value = data/a280.tsp
+ *   2. number of random solutions evaluated, default value = 200
+ * Named options: --seed n
+ */
+int main(int argc, char **argv) {
+    Options options(argc, argv);
+    argc = options.argc();
+    argv = options.argv();
+
+    if (options.has("seed"))
+        Random::set_seed(strtoull(options.get("seed", "0").c_str(), NULL, 10));
+    else
+        Random::set_seed(Random::clock_seed());
+    Random::randomize();
+
+    string tspFile = (argc >= 2) ? argv[1] : "data/a280.tsp";
+    int num_solutions = (argc >= 3) ? atoi(argv[2]) : 200;
+
+    TabuSearch algo(1, 1, tspFile);
+    cout << endl << "Neighbourhood evaluation on " << tspFile << " (" << algo.solution_size << " cities, "
+         << num_solutions << " random solutions)" << endl;
+    bool identical = benchmark(algo, "swap", num_solutions);
+    identical = benchmark(algo, "2opt", num_solutions) && identical;
+    return identical ? 0 : 1;
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <vector>
 #include "solution.h"
+#include "../common/construction.h"
 
 using namespace std;
 
@@ -8,23 +11,8 @@ using namespace std;
  */
 Solution::Solution(int nv) : size(nv) {
     city = new int[size];
-    // Arbitrarily, we always start with city 0
-    city[0] = 0;
-    for(int i = 1; i < size; i++) {
-        bool repeat = true;
-        int a;
-        while(repeat) {
-            repeat = false;
-            // Randomly choose the next city
-            a = Random::random(size);
-            // The city must not already be in the cycle
-            // if so, we repeat
-            for (int j = 0; j < i; j++)
-                if (a == city[j])
-                    repeat = true;
-        }
-        city[i] = a;
-    }
+    // Random cycle, starting with city 0 (Fisher-Yates shuffle)
+    Construction::random_tour(city, size);
     // Arbitrarily impose that city[1] > city[size-1]
     order();
 }
@@ -53,15 +41,24 @@ Solution::~Solution() {
 }
 
 /**
- * Equality operator: tests if two solutions are identical
+ * Equality operator: tests if two solutions are the same cycle.
+ * The solutions do not need to be ordered: they are compared from city 0,
+ * in both directions.
  * @param sol Solution to compare
  * @return true if solutions are identical, false otherwise
  */
 bool Solution::operator==(const Solution& sol) {
-    for(int i = 1; i < size; i++)
-        if (sol.city[i] != this->city[i])
-            return false;
-    return true;
+    int p = find(city, city + size, 0) - city;
+    int q = find(sol.city, sol.city + size, 0) - sol.city;
+    bool forward = true, backward = true;
+    for (int k = 1; k < size && (forward || backward); k++) {
+        int c = city[(p + k) % size];
+        if (sol.city[(q + k) % size] != c)
+            forward = false;
+        if (sol.city[(q - k + size) % size] != c)
+            backward = false;
+    }
+    return forward || backward;
 }
 
 /**
@@ -76,48 +73,31 @@ void Solution::evaluate(int **distance) {
 }
 
 /**
- * Displays the solution.
+ * Displays the solution, ordered as by order() on a copy: the tour itself is
+ * left as it is, since the search may hold its direction in a Tour.
  */
 void Solution::display() {
+    vector<int> ordered(city, city + size);
+    rotate(ordered.begin(), find(ordered.begin(), ordered.end(), 0), ordered.end());
+    if (ordered[1] > ordered[size - 1])
+        reverse(ordered.begin() + 1, ordered.end());
     for(int i = 0; i < size; i++)
-        cout << city[i] << "-";
+        cout << ordered[i] << "-";
     cout << "--> " << fitness << " km" << endl;
 }
 
 /**
  * Orders the tour direction if city[1] > city[size-1].
+ * The tour is rotated and reversed in place.
  */
 void Solution::order() {
-    int temp, k;
     // Place city "0" at the head of the solution (city[0])
-    if (city[0] != 0) {
-        int position_0 = 0;
-        int * city_copy = new int[size];
-        for (int i = 0; i < size; i++) {
-            city_copy[i] = city[i];
-            if (city[i] == 0)
-                position_0 = i;
-        }
-        k = 0;
-        for (int i = position_0; i < size; i++) {
-            city[k] = city_copy[i];
-            k++;
-        }
-        for (int i = 0; i < position_0; i++) {
-            city[k] = city_copy[i];
-            k++;
-        }
-        delete[] city_copy;
-    }
+    if (city[0] != 0)
+        rotate(city, find(city, city + size, 0), city + size);
 
     // The number of the 2nd city must be smaller than that of the last city
-    if (city[1] > city[size - 1]) {
-        for(int k = 1; k <= 1 + (size - 2) / 2; k++) {
-            temp = city[k];
-            city[k] = city[size - k];
-            city[size - k] = temp;
-        }
-    }
+    if (city[1] > city[size - 1])
+        reverse(city + 1, city + size);
 }
 
 /**
@@ -138,7 +118,7 @@ void Solution::swap(int city1, int city2) {
  */
 void Solution::reverse_segment(int start, int end) {
     while (start < end) {
-        swap(city[start], city[end]);
+        swap(start, end);
         start++;
         end--;
     }
@@ -4,7 +4,7 @@
 #include <cmath>
 #include <cstdio>
 #include <iostream>
-#include "random.h"
+#include "../common/random.h"
 
 /**
  * The Solution class represents the structure
@@ -36,7 +36,8 @@ public:
     Solution& operator=(const Solution& source);
 
     /**
-     * Equality operator: tests if two solutions are identical
+     * Equality operator: tests if two solutions are the same cycle, whatever
+     * their starting city and direction
      * @param sol Solution to compare
      * @return true if solutions are identical, false otherwise
      */
@@ -49,12 +50,13 @@ public:
     void evaluate(int **distance);
 
     /**
-     * Displays the solution
+     * Displays the solution ordered, without changing it
      */
     void display();
 
     /**
-     * Orders the tour direction if city[1] > city[size-1]
+     * Orders the tour: starts it from city 0 and reverses it if city[1] > city[size-1].
+     * Only needed to compare or display solutions, the search works on any rotation.
      */
     void order();
 
@@ -3,65 +3,6 @@
 using namespace std;
 
 
-/**
- * @brief Load the coordinates of cities from a TSP file
- * 
- * @param file_path path to the TSP file
- * @param cities vector to store the coordinates of cities
- * @return the dimension (number of cities)
- */ 
-int load_tsp_coordinates(const string& file_path, vector<City>& cities) {
-    ifstream file(file_path);
-    if (!file) {
-        cerr << "Unable to load the file " << file_path << "\n";
-        exit(1);
-    }
-
-    string line;
-    int dimension = 0;
-
-    // Read the dimension and coordinates
-    while (getline(file, line)) {
-        if (line.find("DIMENSION") != string::npos) {
-            istringstream iss(line);
-            string temp;
-            while (iss >> temp) {
-                if (isdigit(temp[0])) {
-                    dimension = stoi(temp);
-                    break;
-                }
-            }
-        }
-        if (line == "NODE_COORD_SECTION") {
-            break;
-        }
-    }
-
-    cities.resize(dimension);
-
-    int id;
-    double x, y;
-    for (int i = 0; i < dimension; ++i) {
-        file >> id >> x >> y;
-        cities[id - 1] = {x, y}; // Make sure the IDs start from 1
-    }
-
-    file.close();
-    return dimension;
-}
-
-/**
- * @brief Calculate the Euclidean distance between two cities
- * 
- * @param a city a
- * @param b city b
- * @return the Euclidean distance between a and b
- */
-double euclidean_distance(const City& a, const City& b) {
-    return sqrt(pow(a.x - b.x, 2) + pow(a.y - b.y, 2));
-}
-
-
 /**
  * Constructor: Initializes the parameters of Tabu Search and generates the initial solution.
  * Initializes the tabu list.
@@ -76,28 +17,78 @@ TabuSearch::TabuSearch(int nbiter, int dt, const string& filename, int verbose,
     no_improvement_counter = 0;
     max_no_improvement_iterations = 50;
     num_perturbations_denominator = 6;
-    vector<City> cities;
     solution_size = load_tsp_coordinates(filename, cities); // Load city coordinates
     constructDistance(solution_size, cities); // Construct distance matrix
+    owns_distances = true;
+    initialize();
+}
+
+/**
+ * Constructor: Initializes a search on the same instance as 'model', sharing its
+ * distance matrix, and generates its own initial solution.
+ */
+TabuSearch::TabuSearch(int nbiter, int dt, const TabuSearch& model, int verbose, int max_duration_seconds) {
+    num_iterations = nbiter;
+    current_iter = 0;
+    tabu_duration = dt;
+    best_evaluation = INT_MAX;
+    this->verbose = verbose;
+    this->max_duration_seconds = max_duration_seconds;
+    no_improvement_counter = 0;
+    max_no_improvement_iterations = model.max_no_improvement_iterations;
+    num_perturbations_denominator = model.num_perturbations_denominator;
+    solution_size = model.solution_size;
+    distances = model.distances;
+    cities = model.cities;
+    owns_distances = false;
+    initialize();
+}
+
+/**
+ * Generates the initial solution and prepares the candidate lists and the tour.
+ */
+void TabuSearch::initialize() {
     current = new Solution(solution_size);
     current->evaluate(distances);
 
-    tabu_list = new int*[solution_size];
-    for(int i = 0; i < solution_size; i++) {
-        tabu_list[i] = new int[solution_size];
-        for(int j = 0; j < solution_size; j++)
-            tabu_list[i][j] = -1;
-    }
-
+    neighborhoods = 1 << MOVE_SWAP;
+    num_candidates = 10;
+    lin_kernighan = NULL;
+    elite_pool = NULL;
+    tenure = tabu_duration;
+    reactive = false;
+    trace_tenure = false;
+    tour_hash = 0;
+    publish_interval = 100;
+    max_perturbations_before_restart = 3;
+    ils_acceptance = ILS_NONE;
+    max_kick_length = 50;
+    // The batch kernels index the matrix with 32-bit offsets
+    use_simd = simdSupported() && (long long)solution_size * solution_size < INT_MAX;
+    wrapped_city.resize(solution_size + 1);
+    buildCandidateLists();
     cout << "The initial random solution is: ";
     current->display();
 
-    tabu_list2 = new int*[tabu_duration];
-    for(int i = 0; i < tabu_duration; i++) {
-        tabu_list2[i] = new int[solution_size];
-        for(int j = 0; j < solution_size; j++)
-            tabu_list2[i][j] = -1;
-    }
+    tour = Tour::create(solution_size);
+    tour->load(current->city);
+}
+
+/**
+ * Builds the initial solution with a construction heuristic.
+ */
+bool TabuSearch::setConstruction(const string& name, int start) {
+    Construction::Method method;
+    if (!Construction::parse(name, method))
+        return false;
+    if (method == Construction::RANDOM)
+        return true;
+    Construction::build(method, cities, distances, current->city, start);
+    current->evaluate(distances);
+    cout << "The initial " << name << " solution is: ";
+    current->display();
+    tour->load(current->city);
+    return true;
 }
 
 /**
@@ -105,15 +96,12 @@ TabuSearch::TabuSearch(int nbiter, int dt, const string& filename, int verbose,
  */
 TabuSearch::~TabuSearch() {
     delete current;
-    for(int i = 0; i < solution_size; i++) {
-        delete[] tabu_list[i];
-        delete[] distances[i];
+    delete tour;
+    delete lin_kernighan;
+    if (owns_distances) {
+        delete[] distances[0];
+        delete[] distances;
     }
-    for(int i = 0; i < tabu_duration; i++)
-        delete[] tabu_list2[i];
-    delete[] tabu_list;
-    delete[] tabu_list2;
-    delete[] distances;
 }
 
 /**
@@ -132,9 +120,11 @@ bool fileExists(const char* filename) {
  * @param cities Vector of cities
  */
 void TabuSearch::constructDistance(int nv, const vector<City>& cities) {
+    // The rows are contiguous, so that distances[0][i * nv + j] = distances[i][j]
     distances = new int*[nv];
-    for(int i = 0; i < nv; i++)
-        distances[i] = new int[nv];
+    distances[0] = new int[(size_t)nv * nv];
+    for(int i = 1; i < nv; i++)
+        distances[i] = distances[0] + (size_t)i * nv;
     
     for (int i = 0; i < nv; i++) {
         for (int j = 0; j < nv; j++) {
@@ -148,74 +138,60 @@ void TabuSearch::constructDistance(int nv, const vector<City>& cities) {
 }
 
 bool TabuSearch::notTabu(int i, int j, int fitness) {
-    if(tabu_list[i][j] < current_iter || fitness < best_evaluation)
+    if(!tabu_list.is_tabu(i, j, current_iter) || fitness < best_evaluation)
         return true;
     else
         return false;
 }
 
-bool TabuSearch::notTabu2(Solution* sol) {
-    for(int i = 0; i < tabu_duration; i++) {
-        for(int j = 1; j < solution_size; j++) {
-            if (tabu_list2[i][j] != sol->city[j])
-                j = solution_size;
-            else if (j == solution_size - 1)
-                return false;
-        }
-    }
-    for(int i = 0; i < tabu_duration; i++) {
-        for(int j = 1; j < solution_size; j++) {
-            if (tabu_list2[i][j] != sol->city[solution_size - j])
-                j = solution_size;
-            else if (j == solution_size - 1)
-                return false;
-        }
-    }
+bool TabuSearch::notTabuEdges(int a1, int b1, int a2, int b2, int a3, int b3, int fitness) {
+    if (fitness < best_evaluation)
+        return true;
+    if (tabu_edges.is_tabu(a1, b1, current_iter) || tabu_edges.is_tabu(a2, b2, current_iter))
+        return false;
+    if (a3 >= 0 && tabu_edges.is_tabu(a3, b3, current_iter))
+        return false;
     return true;
 }
 
-void TabuSearch::updateTabuList2(Solution* sol, int& position) {
-    if (tabu_duration != 0) {
-        for(int j = 0; j < solution_size; j++)
-            tabu_list2[position][j] = sol->city[j];
-        position++;
-        if (position == tabu_duration)
-            position = 0;
-    }
-}
-
 /**
  * Provides the best non-tabu neighbor using swap.
- * 
- * @param best_i Best city i
- * @param best_j Best city j
+ * Each neighbor is evaluated in O(1) from the four edges around the two cities.
+ *
+ * @param best Best move found so far, updated if a better one is found
  */
-void TabuSearch::neighborhoodSwap(int &best_i, int &best_j) {
-    int best_neighbor;
-    best_neighbor = 100000;
+void TabuSearch::neighborhoodSwap(Move &best) {
+    if (use_simd) {
+        neighborhoodSwapSimd(best);
+        return;
+    }
+    int n = solution_size;
+    int *t = current->city;
 
     // Select the first city for the move
-    for(int i = 0; i < solution_size; i++) {
+    for(int i = 0; i < n; i++) {
         // Select the second city for the move
-        for(int j = i + 1; j < solution_size; j++) {
-            if ( ((i != 0) || (j != solution_size - 1)) && ((i != 0) || (j != solution_size - 2)) ) {
-                // Transform the current solution to the neighbor
-                // using the move defined by the pair of cities
-                current->swap(i, j);
-                // Evaluate this neighbor
-                current->evaluate(distances);
+        for(int j = i + 1; j < n; j++) {
+            if ( ((i != 0) || (j != n - 1)) && ((i != 0) || (j != n - 2)) ) {
+                int a = t[i], b = t[j];
+                int pi = t[(i - 1 + n) % n], ni = t[i + 1];
+                int pj = t[j - 1], nj = t[(j + 1) % n];
+                int delta;
+                // Variation of the fitness when the cities at i and j are swapped
+                if (j == i + 1)
+                    delta = distances[pi][b] + distances[a][nj] - distances[pi][a] - distances[b][nj];
+                else
+                    delta = distances[pi][b] + distances[b][ni] + distances[pj][a] + distances[a][nj]
+                          - distances[pi][a] - distances[a][ni] - distances[pj][b] - distances[b][nj];
                 // If this move is not tabu and
                 // if this neighbor has the best fitness
                 // then this neighbor becomes the best non-tabu neighbor
-                if(notTabu(i, j, current->fitness) && current->fitness < best_neighbor) {
-                    best_neighbor  = current->fitness;
-                    best_i         = i;
-                    best_j         = j;
+                if(delta < best.delta && notTabu(min(a, b), max(a, b), current->fitness + delta)) {
+                    best.type  = MOVE_SWAP;
+                    best.a     = a;
+                    best.b     = b;
+                    best.delta = delta;
                 }
-                // Re-transform this neighbor back to the current solution
-                current->swap(i, j);
-                // Re-evaluate the current solution
-                current->evaluate(distances);
             }
         }
     }
@@ -223,43 +199,313 @@ void TabuSearch::neighborhoodSwap(int &best_i, int &best_j) {
 
 /**
  * Provides the best non-tabu neighbor using 2-opt.
- * 
- * @param best_i Best city i
- * @param best_j Best city j
+ * Reversing the path t[i]..t[j] replaces the edges (t[i-1], t[i]) and (t[j], t[j+1])
+ * by (t[i-1], t[j]) and (t[i], t[j+1]).
+ *
+ * @param best Best move found so far, updated if a better one is found
+ */
+void TabuSearch::neighborhood2opt(Move &best) {
+    if (use_simd) {
+        neighborhood2optSimd(best);
+        return;
+    }
+    int n = solution_size;
+    int *t = current->city;
+
+    for(int i = 0; i < n - 1; i++) {
+        for(int j = i + 1; j < n; j++) {
+            int a = t[i], b = t[j];
+            int p = t[(i - 1 + n) % n], q = t[(j + 1) % n];
+            // Reversing the whole cycle (or all cities but one) gives the same cycle
+            if (p == b || p == q)
+                continue;
+            int delta = distances[p][b] + distances[a][q] - distances[p][a] - distances[b][q];
+            if(delta < best.delta && notTabuEdges(p, b, a, q, -1, -1, current->fitness + delta)) {
+                best.type = MOVE_2OPT;
+                best.a = a;
+                best.b = b;
+                best.delta = delta;
+            }
+        }
+    }
+}
+
+/**
+ * Provides the best non-tabu neighbor using Or-opt.
+ * The path s1..sL (L = 1..3) between p and q is removed and inserted between e and f,
+ * with s1 or sL next to one of its candidate cities:
+ * the edges (p, s1), (sL, q), (e, f) are replaced by (p, q), (e, s1), (sL, f)
+ * (or (e, sL), (s1, f) when the path is reversed).
+ *
+ * @param best Best move found so far, updated if a better one is found
  */
-void TabuSearch::neighborhood2opt(int &best_i, int &best_j) {
-    int best_neighbor = 100000;
-
-    for(int i = 0; i < solution_size - 1; i++) {
-        for(int j = i + 1; j < solution_size; j++) {
-            if (i != 0 || j != solution_size - 1) {
-                current->reverse_segment(i, j); // Perform 2-opt exchange
-                current->evaluate(distances);
-
-                if(notTabu(i, j, current->fitness) && current->fitness < best_neighbor) {
-                    best_neighbor = current->fitness;
-                    best_i = i;
-                    best_j = j;
+void TabuSearch::neighborhoodOrOpt(Move &best) {
+    int n = solution_size;
+
+    for (int s1 = 0; s1 < n; s1++) {
+        int sl = s1;
+        for (int length = 1; length <= 3 && length + 3 <= n; length++) {
+            if (length > 1)
+                sl = tour->next(sl);
+            int p = tour->prev(s1), q = tour->next(sl);
+            int removal = distances[p][q] - distances[p][s1] - distances[sl][q];
+
+            // The path is attached by s1, then by sL, to one of its candidates
+            for (int end = 0; end < 2; end++) {
+                if (end == 1 && length == 1)
+                    break;
+                int x = (end == 0) ? s1 : sl;
+                for (size_t k = 0; k < candidates[x].size(); k++) {
+                    int c = candidates[x][k];
+                    // Insertion after c (e = c) or before c (f = c)
+                    for (int side = 0; side < 2; side++) {
+                        int e = (side == 0) ? c : tour->prev(c);
+                        // e must not belong to the path nor be p
+                        if (e == p || tour->between(s1, e, sl))
+                            continue;
+                        int f = tour->next(e);
+                        // x is next to e when inserted after c, next to f otherwise
+                        bool reversed = ((x == s1) == (side == 1)) && length > 1;
+                        int first = reversed ? sl : s1;
+                        int last = reversed ? s1 : sl;
+                        int delta = removal + distances[e][first] + distances[last][f] - distances[e][f];
+                        if (delta < best.delta
+                            && notTabuEdges(p, q, e, first, last, f, current->fitness + delta)) {
+                            best.type = MOVE_OROPT;
+                            best.a = s1;
+                            best.b = sl;
+                            best.c = e;
+                            best.reversed = reversed;
+                            best.delta = delta;
+                        }
+                    }
                 }
+            }
+        }
+    }
+}
 
-                current->reverse_segment(i, j); // Undo 2-opt exchange
-                current->evaluate(distances);
+/**
+ * Provides the best non-tabu neighbor using restricted 3-opt.
+ * With t2 = next(t1), t4 = next(t3) and t6 = next(t5), the paths t2..t3 and t4..t5
+ * are exchanged: the edges (t1, t2), (t3, t4), (t5, t6) are replaced by
+ * (t1, t4), (t5, t2), (t3, t6), where t4 is a candidate of t1 and t5 a candidate of t2.
+ *
+ * @param best Best move found so far, updated if a better one is found
+ */
+void TabuSearch::neighborhood3opt(Move &best) {
+    int n = solution_size;
+
+    for (int t1 = 0; t1 < n; t1++) {
+        int t2 = tour->next(t1);
+        for (size_t k4 = 0; k4 < candidates[t1].size(); k4++) {
+            int t4 = candidates[t1][k4];
+            if (t4 == t2)
+                continue;
+            int t3 = tour->prev(t4);
+            int partial = distances[t1][t4] - distances[t1][t2] - distances[t3][t4];
+            for (size_t k5 = 0; k5 < candidates[t2].size(); k5++) {
+                int t5 = candidates[t2][k5];
+                // t5 must lie on the path t4..t1, t1 excluded
+                if (t5 == t1 || !tour->between(t4, t5, t1))
+                    continue;
+                int t6 = tour->next(t5);
+                int delta = partial + distances[t5][t2] + distances[t3][t6] - distances[t5][t6];
+                if (delta < best.delta
+                    && notTabuEdges(t1, t4, t5, t2, t3, t6, current->fitness + delta)) {
+                    best.type = MOVE_3OPT;
+                    best.a = t2;
+                    best.b = t4;
+                    best.c = t5;
+                    best.reversed = false;
+                    best.delta = delta;
+                }
             }
         }
     }
 }
 
+/**
+ * Provides the best non-tabu neighbor among the selected neighbourhoods.
+ *
+ * @param best Best move found, best.type == MOVE_NONE if every move is tabu
+ */
+void TabuSearch::selectMove(Move &best) {
+    best.type = MOVE_NONE;
+    best.delta = INT_MAX;
+    if (use_simd && (neighborhoods & ((1 << MOVE_SWAP) | (1 << MOVE_2OPT)))) {
+        copy(current->city, current->city + solution_size, wrapped_city.begin());
+        wrapped_city[solution_size] = current->city[0];
+    }
+    if (neighborhoods & (1 << MOVE_SWAP))
+        neighborhoodSwap(best);
+    if (neighborhoods & (1 << MOVE_2OPT))
+        neighborhood2opt(best);
+    if (neighborhoods & (1 << MOVE_OROPT))
+        neighborhoodOrOpt(best);
+    if (neighborhoods & (1 << MOVE_3OPT))
+        neighborhood3opt(best);
+}
+
+/**
+ * Makes the attributes of a move tabu: the pair of cities for a swap,
+ * the removed edges for the other moves (they cannot be added back).
+ *
+ * @param move Move about to be applied to the current solution
+ */
+void TabuSearch::makeTabu(const Move &move) {
+    int expiry = current_iter + tenure;
+    int removed[6];
+    int num_removed = 0;
+
+    switch (move.type) {
+        case MOVE_SWAP:
+            tabu_list.add(move.a, move.b, expiry, current_iter);
+            return;
+        case MOVE_2OPT:
+            removed[0] = tour->prev(move.a); removed[1] = move.a;
+            removed[2] = move.b;             removed[3] = tour->next(move.b);
+            num_removed = 2;
+            break;
+        case MOVE_OROPT:
+            removed[0] = tour->prev(move.a); removed[1] = move.a;
+            removed[2] = move.b;             removed[3] = tour->next(move.b);
+            removed[4] = move.c;             removed[5] = tour->next(move.c);
+            num_removed = 3;
+            break;
+        case MOVE_3OPT:
+            removed[0] = tour->prev(move.a); removed[1] = move.a;
+            removed[2] = tour->prev(move.b); removed[3] = move.b;
+            removed[4] = move.c;             removed[5] = tour->next(move.c);
+            num_removed = 3;
+            break;
+        default:
+            return;
+    }
+    for (int k = 0; k < num_removed; k++) {
+        tabu_edges.add(removed[2 * k], removed[2 * k + 1], expiry, current_iter);
+    }
+}
+
+/**
+ * Applies a move to the tour with flips, then copies the tour
+ * into the current solution. The fitness is not updated.
+ *
+ * @param move Move to apply
+ */
+void TabuSearch::applyMove(const Move &move) {
+    // Every edge removed or added by a move is incident to one of these cities:
+    // the hash is updated with the edges around them, before and after the move
+    int touched[4] = { move.a, move.b, -1, -1 };
+    int num_touched = 2;
+    if (reactive && (move.type == MOVE_OROPT || move.type == MOVE_3OPT)) {
+        touched[2] = move.c;
+        touched[3] = (move.type == MOVE_OROPT) ? tour->prev(move.a) : tour->prev(move.b);
+        num_touched = 4;
+    }
+    if (reactive)
+        tour_hash ^= edgesHash(touched, num_touched);
+
+    switch (move.type) {
+        case MOVE_SWAP: {
+            // p a na ... pb b nb -> p b pb ... na a nb -> p b na ... pb a nb
+            int na = tour->next(move.a), pb = tour->prev(move.b);
+            if (na == move.b) {
+                tour->flip(move.a, move.b);
+            } else if (tour->next(move.b) == move.a) {
+                tour->flip(move.b, move.a);
+            } else {
+                tour->flip(move.a, move.b);
+                tour->flip(pb, na);
+            }
+            break;
+        }
+        case MOVE_2OPT:
+            tour->flip(move.a, move.b);
+            break;
+        case MOVE_OROPT: {
+            // p s1..sL q..e f -> p e..q sL..s1 f -> p q..e sL..s1 f
+            int q = tour->next(move.b);
+            tour->flip(move.a, move.c);
+            tour->flip(move.c, q);
+            if (!move.reversed)
+                tour->flip(move.b, move.a);
+            break;
+        }
+        case MOVE_3OPT: {
+            // t1 t2..t3 t4..t5 t6 -> t1 t5..t4 t3..t2 t6 -> t1 t4..t5 t2..t3 t6
+            int t3 = tour->prev(move.b);
+            tour->flip(move.a, move.c);
+            tour->flip(move.c, move.b);
+            tour->flip(t3, move.a);
+            break;
+        }
+        default:
+            break;
+    }
+    if (reactive)
+        tour_hash ^= edgesHash(touched, num_touched);
+    tour->store(current->city);
+}
+
+/**
+ * XOR of the keys of the edges incident to the given cities, each edge counted once.
+ *
+ * @param cities Cities
+ * @param num_cities Number of cities (at most 4)
+ */
+uint64_t TabuSearch::edgesHash(const int *cities, int num_cities) {
+    pair<int, int> edges[8];
+    int num_edges = 0;
+    for (int k = 0; k < num_cities; k++) {
+        int c = cities[k], p = tour->prev(c), n = tour->next(c);
+        edges[num_edges++] = make_pair(min(p, c), max(p, c));
+        edges[num_edges++] = make_pair(min(c, n), max(c, n));
+    }
+    sort(edges, edges + num_edges);
+    uint64_t hash = 0;
+    for (int k = 0; k < num_edges; k++)
+        if (k == 0 || edges[k] != edges[k - 1])
+            hash ^= TourHash::edge_key(edges[k].first, edges[k].second);
+    return hash;
+}
+
+/**
+ * Builds the candidate lists: the num_candidates nearest cities of each city.
+ */
+void TabuSearch::buildCandidateLists() {
+    int k = min(num_candidates, solution_size - 1);
+    vector<int> others;
+    candidates.assign(solution_size, vector<int>());
+    for (int c = 0; c < solution_size; c++) {
+        others.clear();
+        for (int o = 0; o < solution_size; o++)
+            if (o != c)
+                others.push_back(o);
+        partial_sort(others.begin(), others.begin() + k, others.end(),
+                     [this, c](int u, int v) { return distances[c][u] < distances[c][v]; });
+        candidates[c].assign(others.begin(), others.begin() + k);
+    }
+}
+
 /**
  * Perturbs the current solution by swapping a few cities.
+ * The perturbed solution is then brought back to a local optimum
+ * by Lin-Kernighan if enabled.
  */
 void TabuSearch::perturb_solution() {
     int num_perturbations = solution_size / num_perturbations_denominator;
     for (int i = 0; i < num_perturbations; ++i) {
-        int city1 = rand() % solution_size;
-        int city2 = rand() % solution_size;
+        int city1 = Random::random(solution_size);
+        int city2 = Random::random(solution_size);
         current->swap(city1, city2);
     }
+    if (lin_kernighan)
+        lin_kernighan->optimize(current->city);
     current->evaluate(distances);
+    tour->load(current->city);
+    if (reactive)
+        tour_hash = TourHash::of(current->city, solution_size);
 }
 
 void TabuSearch::setMaxNoImprovementIterations(int value) {
@@ -270,12 +516,256 @@ void TabuSearch::setNumPerturbationsDenominator(int value) {
     num_perturbations_denominator = value;
 }
 
+bool TabuSearch::setNeighborhoods(const string& names) {
+    int selected = 0;
+    stringstream ss(names);
+    string name;
+    while (getline(ss, name, ',')) {
+        if (name == "swap")
+            selected |= 1 << MOVE_SWAP;
+        else if (name == "2opt")
+            selected |= 1 << MOVE_2OPT;
+        else if (name == "oropt")
+            selected |= 1 << MOVE_OROPT;
+        else if (name == "3opt")
+            selected |= 1 << MOVE_3OPT;
+        else if (name == "all")
+            selected |= (1 << MOVE_SWAP) | (1 << MOVE_2OPT) | (1 << MOVE_OROPT) | (1 << MOVE_3OPT);
+        else
+            return false;
+    }
+    if (selected == 0)
+        return false;
+    neighborhoods = selected;
+    return true;
+}
+
+void TabuSearch::setSimd(bool enabled) {
+    use_simd = enabled && simdSupported() && (long long)solution_size * solution_size < INT_MAX;
+}
+
+void TabuSearch::setNumCandidates(int value) {
+    num_candidates = value;
+    buildCandidateLists();
+}
 
+void TabuSearch::setLinKernighan(bool enabled) {
+    delete lin_kernighan;
+    lin_kernighan = enabled ? new LinKernighan<int>(distances, solution_size) : NULL;
+}
+
+bool TabuSearch::setIteratedLocalSearch(const string& acceptance, int max_kick_length) {
+    if (acceptance == "none")
+        ils_acceptance = ILS_NONE;
+    else if (acceptance == "better")
+        ils_acceptance = ILS_BETTER;
+    else if (acceptance == "walk")
+        ils_acceptance = ILS_RANDOM_WALK;
+    else if (acceptance == "anneal")
+        ils_acceptance = ILS_ANNEALING;
+    else
+        return false;
+    this->max_kick_length = max(1, max_kick_length);
+    return true;
+}
+
+void TabuSearch::setElitePool(ElitePool* pool, int publish_interval, int max_perturbations_before_restart) {
+    elite_pool = pool;
+    this->publish_interval = max(1, publish_interval);
+    this->max_perturbations_before_restart = max_perturbations_before_restart;
+}
+
+void TabuSearch::setReactive(bool enabled) {
+    reactive = enabled;
+    min_tenure = max(1, min(tabu_duration, 5));
+    max_tenure = max(tabu_duration, solution_size / 2);
+}
+
+void TabuSearch::enableTenureTrace() {
+    trace_tenure = true;
+}
+
+bool TabuSearch::writeTenureTrace(const string& filename) {
+    ofstream file(filename);
+    if (!file)
+        return false;
+    file << "# iteration tenure" << endl;
+    for (size_t k = 0; k < tenure_trace.size(); k++)
+        file << tenure_trace[k].first << " " << tenure_trace[k].second << endl;
+    return true;
+}
+
+/**
+ * Reactive tenure: when the current solution was already visited, the search
+ * is cycling and the tenure grows by 10%. When no solution has been repeated
+ * for twice the mean cycle length (and at least 'tenure' iterations), the
+ * tenure shrinks by 10%.
+ */
+void TabuSearch::reactToRepetitions() {
+    VisitedSolution& entry = visited[tour_hash & (visited.size() - 1)];
+    int new_tenure = tenure;
+    if (entry.iteration >= 0 && entry.hash == tour_hash) {
+        int cycle_length = current_iter - entry.iteration;
+        mean_cycle_length = (mean_cycle_length == 0) ? cycle_length : 0.9 * mean_cycle_length + 0.1 * cycle_length;
+        new_tenure = min(max_tenure, max(tenure + 1, (int)(tenure * 1.1)));
+    } else if (current_iter - last_tenure_change > max((double)tenure, 2 * mean_cycle_length)) {
+        new_tenure = max(min_tenure, min(tenure - 1, (int)(tenure * 0.9)));
+    }
+    entry.hash = tour_hash;
+    entry.iteration = current_iter;
+
+    if (new_tenure != tenure) {
+        tenure = new_tenure;
+        last_tenure_change = current_iter;
+        if (trace_tenure)
+            tenure_trace.push_back(make_pair(current_iter, tenure));
+    }
+}
+
+/**
+ * Restarts the search from a perturbed copy of an elite solution.
+ * @return false if the elite pool is empty
+ */
+bool TabuSearch::restart_from_elite() {
+    if (!elite_pool || !elite_pool->sample(*current))
+        return false;
+    perturb_solution();
+    return true;
+}
+
+
+/**
+ * Exchanges the paths B = cities[s..s+l1-1] and C = cities[s+l1..s+l1+l2-1]
+ * (indices modulo n): p B C q becomes p C B q, so the edges (p, b1), (bl, c1), (cl, q)
+ * are replaced by (p, c1), (cl, b1), (bl, q).
+ */
+int TabuSearch::doubleBridgeKick(int *cities, int *touched) {
+    int n = solution_size;
+    int longest = min(max_kick_length, (n - 2) / 2);
+    int l1 = 1 + Random::random(longest);
+    int l2 = 1 + Random::random(longest);
+    int s = Random::random(n);
+
+    int p = cities[(s - 1 + n) % n], q = cities[(s + l1 + l2) % n];
+    int b1 = cities[s], bl = cities[(s + l1 - 1) % n];
+    int c1 = cities[(s + l1) % n], cl = cities[(s + l1 + l2 - 1) % n];
+    int delta = distances[p][c1] + distances[cl][b1] + distances[bl][q]
+              - distances[p][b1] - distances[bl][c1] - distances[cl][q];
+
+    kick_buffer.resize(l1 + l2);
+    for (int k = 0; k < l2; k++)
+        kick_buffer[k] = cities[(s + l1 + k) % n];
+    for (int k = 0; k < l1; k++)
+        kick_buffer[l2 + k] = cities[(s + k) % n];
+    for (int k = 0; k < l1 + l2; k++)
+        cities[(s + k) % n] = kick_buffer[k];
+
+    touched[0] = p;  touched[1] = b1; touched[2] = bl;
+    touched[3] = c1; touched[4] = cl; touched[5] = q;
+    return delta;
+}
+
+/**
+ * Iterated local search
+ */
+Solution* TabuSearch::iteratedLocalSearch() {
+    if (!lin_kernighan)
+        setLinKernighan(true);
+
+    Solution* best_solution = new Solution(solution_size);
+    Solution* candidate = new Solution(solution_size);
+    int touched[6];
+    int count_best_updates = 0;
+    int count_accepted = 0;
+    bool published = false;
+
+    // The first local optimum
+    lin_kernighan->optimize(current->city);
+    current->evaluate(distances);
+    *best_solution = *current;
+    best_solution->fitness = best_evaluation = current->fitness;
+    // Initial temperature: a tenth of the mean length of an edge
+    double initial_temperature = 0.1 * current->fitness / solution_size;
+
+    auto start_time = chrono::high_resolution_clock::now();
+
+    for(current_iter = 0; current_iter < num_iterations; current_iter++) {
+        double progress = (double)current_iter / num_iterations;
+        if (max_duration_seconds > 0) {
+            double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start_time).count();
+            if (elapsed > max_duration_seconds) {
+                cout << "Max duration reached. Stopping optimization." << endl;
+                break;
+            }
+            progress = max(progress, elapsed / max_duration_seconds);
+        }
+
+        // Kick a copy of the current solution and repair it around the kick:
+        // the fitness follows from the variations, without a full evaluation
+        *candidate = *current;
+        int delta = doubleBridgeKick(candidate->city, touched);
+        delta -= lin_kernighan->optimize(candidate->city, touched, 6);
+        candidate->fitness = current->fitness + delta;
+
+        bool accepted;
+        switch (ils_acceptance) {
+            case ILS_RANDOM_WALK:
+                accepted = true;
+                break;
+            case ILS_ANNEALING: {
+                double temperature = initial_temperature * (1 - progress);
+                accepted = delta <= 0 || (temperature > 0 && Random::uniform() < exp(-delta / temperature));
+                break;
+            }
+            default:
+                accepted = delta <= 0;
+                break;
+        }
+        if (accepted) {
+            swap(current, candidate);
+            count_accepted++;
+        }
+
+        if (current->fitness < best_evaluation) {
+            best_evaluation = current->fitness;
+            *best_solution = *current; // The assignment copies the cities only
+            best_solution->fitness = best_evaluation;
+            count_best_updates++;
+            published = false;
+        }
+
+        // Periodically share the best solution with the other threads
+        if (elite_pool && !published && current_iter % publish_interval == 0) {
+            best_solution->order();
+            elite_pool->publish(*best_solution);
+            published = true;
+        }
+
+        if (verbose) {
+            printf("%d\t%d\t%d\n", current_iter, current->fitness, best_evaluation);
+        }
+    }
+
+    if (verbose) {
+        cout << "Number of best solution updates: " << count_best_updates << endl;
+        cout << "Number of accepted kicks: " << count_accepted << " / " << current_iter << endl;
+    }
+
+    delete candidate;
+    tour->load(current->city);
+    best_solution->order();
+    if (elite_pool && !published)
+        elite_pool->publish(*best_solution);
+    return best_solution;
+}
 
 /**
  * Main procedure of the search
  */
 Solution* TabuSearch::optimize() {
+    if (ils_acceptance != ILS_NONE)
+        return iteratedLocalSearch();
+
     bool first = true; // Indicates if it's the first time
     bool descent = false; // Indicates if the current solution is in a descent
 
@@ -284,15 +774,32 @@ Solution* TabuSearch::optimize() {
     // The best solution found (= smallest minimum found) to keep
     Solution* best_solution = new Solution(solution_size);
 
-    int best_i = 0; // The pair (best_i, best_j) represents the best non-tabu move
-    int best_j = 0;
-    best_evaluation = current->fitness;
+    Move best_move; // The best non-tabu move
+    // The start solution is the best one until a move improves it
+    *best_solution = *current;
+    best_solution->fitness = best_evaluation = current->fitness;
     f_before = 10000000;
 
     // Counters for best solution updates and local minima
     int count_best_updates = 0;
     int count_local_minima = 0;
 
+    // Perturbations since the last improvement, and whether the pool has the best solution
+    int num_perturbations = 0;
+    bool published = false;
+
+    // Tables of the reactive tenure
+    if (reactive) {
+        VisitedSolution empty = { 0, -1 };
+        visited.assign(1 << 16, empty);
+        tour_hash = TourHash::of(current->city, solution_size);
+        last_tenure_change = 0;
+        mean_cycle_length = 0;
+    }
+    tenure = tabu_duration;
+    if (trace_tenure)
+        tenure_trace.assign(1, make_pair(0, tenure));
+
     // Timer start for max duration
     auto start_time = chrono::high_resolution_clock::now();
 
@@ -308,12 +815,15 @@ Solution* TabuSearch::optimize() {
             }
         }
 
-        neighborhoodSwap(best_i, best_j); // Get the best non-tabu move
-        current->swap(best_i, best_j); // Move the current solution using this move
-        //neighborhood2opt(best_i, best_j); // Get the best non-tabu move
-        //current->reverse_segment(best_i, best_j); // Move the current solution using this move
+        selectMove(best_move); // Get the best non-tabu move among the selected neighbourhoods
+        if (best_move.type != MOVE_NONE) {
+            makeTabu(best_move); // Update the tabu list
+            applyMove(best_move); // Move the current solution using this move
+        }
+        if (reactive)
+            reactToRepetitions(); // Adapt the tenure to the cycles of the search
 
-        current->order(); // Reorder the solution starting from 0
+        // The solution is not reordered: the moves work on any rotation of the tour
         current->evaluate(distances); // Evaluate the new current solution
 
         f_after = current->fitness; // Fitness value after the move
@@ -324,6 +834,8 @@ Solution* TabuSearch::optimize() {
             best_solution->evaluate(distances); // Evaluate the best solution
             count_best_updates++; // Increment the counter for best solution updates
             no_improvement_counter = 0; // Reset the no improvement counter
+            num_perturbations = 0;
+            published = false;
         } else { // If not in the smallest minimum found but in a local minimum
             // Local minimum detection criteria. Two cases:
             // 1. If the new solution is worse than the old one
@@ -355,13 +867,27 @@ Solution* TabuSearch::optimize() {
                 if (verbose) {
                     cout << "Applying perturbation at iteration " << current_iter << endl;
                 }
-                perturb_solution();
+                // Stagnation: restart from an elite solution found by any thread
+                num_perturbations++;
+                if (elite_pool && num_perturbations > max_perturbations_before_restart && restart_from_elite()) {
+                    if (verbose) {
+                        cout << "Restarting from an elite solution at iteration " << current_iter << endl;
+                    }
+                    num_perturbations = 0;
+                } else {
+                    perturb_solution();
+                }
                 no_improvement_counter = 0;
             }
         }
 
-        // Update the tabu list
-        tabu_list[best_i][best_j] = current_iter + tabu_duration;
+        // Periodically share the best solution with the other threads
+        if (elite_pool && !published && current_iter % publish_interval == 0) {
+            best_solution->order(); // The pool compares ordered solutions
+            elite_pool->publish(*best_solution);
+            published = true;
+        }
+
         f_before = f_after;
 
         // Output: index of iteration and the optimal solution so far
@@ -376,5 +902,9 @@ Solution* TabuSearch::optimize() {
         cout << "Number of local minima visited: " << count_local_minima << endl;
     }
 
+    best_solution->order();
+    if (elite_pool && !published)
+        elite_pool->publish(*best_solution);
+
     return best_solution;
 }
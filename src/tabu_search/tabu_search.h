@@ -10,16 +10,68 @@
 #include <cmath>
 #include <chrono>
 #include <climits>
+#include <algorithm>
 #include "solution.h"
+#include "elite_pool.h"
+#include "tabu_store.h"
+#include "../common/lin_kernighan.h"
+#include "../common/tour.h"
+#include "../common/tsp_file.h"
+#include "../common/tour_hash.h"
+#include "../common/construction.h"
 
 using namespace std;
 
 /**
- * This structure defines a city with its coordinates.
+ * Types of moves (neighbourhoods) available to the Tabu Search.
  */
-struct City {
-    double x;
-    double y;
+enum MoveType {
+    MOVE_NONE = 0,   ///< No admissible move was found
+    MOVE_SWAP = 1,   ///< Swap of two cities
+    MOVE_2OPT = 2,   ///< Reversal of a path
+    MOVE_OROPT = 3,  ///< Move of a path of 1 to 3 cities elsewhere, possibly reversed
+    MOVE_3OPT = 4    ///< Exchange of two consecutive paths (pure 3-opt reconnection)
+};
+
+/**
+ * This structure describes a move by the cities it involves, so that it does
+ * not depend on where the tour starts. The meaning of the cities depends on
+ * the type of the move:
+ *  - swap   : cities a and b are swapped
+ *  - 2-opt  : the path a..b is reversed
+ *  - Or-opt : the path a..b is inserted after c, reversed or not
+ *  - 3-opt  : the paths from a to prev(b) and from b to c are exchanged
+ */
+struct Move {
+    MoveType type;
+    int a;
+    int b;
+    int c;
+    bool reversed;
+    int delta;              ///< Variation of the fitness caused by the move
+};
+
+/**
+ * Acceptance criteria of the iterated local search: after a kick and its repair,
+ * the new local optimum replaces the current one
+ *  - better      : if it is not longer
+ *  - random walk : always
+ *  - annealing   : if it is not longer, or with probability exp(-increase / T),
+ *                  the temperature T decreasing linearly to 0 during the search
+ */
+enum IlsAcceptance {
+    ILS_NONE = 0,        ///< Tabu search, no iterated local search
+    ILS_BETTER = 1,
+    ILS_RANDOM_WALK = 2,
+    ILS_ANNEALING = 3
+};
+
+/**
+ * An entry of the table of visited solutions of the reactive tabu search.
+ */
+struct VisitedSolution {
+    uint64_t hash;          ///< Hash of the solution
+    int iteration;          ///< Last iteration at which it was visited, -1 if the entry is empty
 };
 
 /**
@@ -34,9 +86,34 @@ class TabuSearch {
         int tabu_duration;               ///< Tabu duration in number of iterations
         int solution_size;               ///< Number of cities in the solution
         Solution *current;               ///< Current solution managed by TabuSearch
-        int **tabu_list2;                ///< List of tabu solutions
-        int **tabu_list;                 ///< List of tabu durations associated with each pair of cities
-        int **distances;                 ///< Distance matrix between cities
+        TabuStore tabu_list;             ///< Pairs of cities swapped recently, with their tabu durations
+        TabuStore tabu_edges;            ///< Edges removed by 2-opt, Or-opt and 3-opt moves, with their tabu durations
+        int neighborhoods;               ///< Bit set of the neighbourhoods explored, bit k = MoveType k
+        int num_candidates;              ///< Number of nearest cities in each candidate list
+        vector<vector<int> > candidates; ///< candidates[c] = nearest cities of c, closest first
+        Tour *tour;                      ///< Current solution seen as a cycle, used to evaluate and apply the moves
+        LinKernighan<int> *lin_kernighan; ///< Improvement applied after each perturbation, NULL if disabled
+        int **distances;                 ///< Distance matrix between cities, rows stored contiguously
+        vector<City> cities;             ///< Coordinates of the cities, used by the construction heuristics
+        bool use_simd;                   ///< true if the swap and 2-opt neighbourhoods use the AVX2 kernels
+        vector<int> wrapped_city;        ///< Current solution followed by its first city, read by the AVX2 kernels
+        bool owns_distances;             ///< false if the distance matrix is shared with another search
+        ElitePool *elite_pool;           ///< Pool shared by the threads of a parallel search, NULL if none
+        int publish_interval;            ///< Number of iterations between two publications to the elite pool
+        int max_perturbations_before_restart; ///< Perturbations without improvement before restarting from the elite pool
+        int tenure;                      ///< Current tabu duration, equal to tabu_duration unless reactive
+        bool reactive;                   ///< true if the tenure reacts to the revisited solutions
+        int min_tenure;                  ///< Smallest tenure of the reactive search
+        int max_tenure;                  ///< Largest tenure of the reactive search
+        int last_tenure_change;          ///< Iteration of the last change of the tenure
+        double mean_cycle_length;        ///< Moving average of the number of iterations between two visits of a solution
+        uint64_t tour_hash;              ///< Hash of the current solution, maintained by applyMove() when reactive
+        vector<VisitedSolution> visited; ///< Visited solutions, indexed by the low bits of their hash
+        bool trace_tenure;               ///< true if the changes of the tenure are recorded
+        vector<pair<int, int> > tenure_trace; ///< (iteration, tenure) at each change of the tenure
+        IlsAcceptance ils_acceptance;    ///< Acceptance criterion of the iterated local search, ILS_NONE for the tabu search
+        int max_kick_length;             ///< Maximum length of each of the two paths exchanged by a kick
+        vector<int> kick_buffer;         ///< Cities of the two paths exchanged by a kick
         int best_evaluation;             ///< Best evaluation found
         int verbose;                     ///< Verbose output flag
         int max_duration_seconds;        ///< Maximum duration in seconds
@@ -53,6 +130,16 @@ class TabuSearch {
          * @param filename Name of the TSP file
          */
         TabuSearch(int nbiter, int dt, const string& filename, int verbose = 0, int max_duration_seconds = -1);
+
+        /**
+         * Constructs a TabuSearch instance on the same instance as another one,
+         * sharing its distance matrix (which must outlive this search).
+         *
+         * @param nbiter Number of iterations
+         * @param dt Tabu duration
+         * @param model Search whose instance is used
+         */
+        TabuSearch(int nbiter, int dt, const TabuSearch& model, int verbose = 0, int max_duration_seconds = -1);
         
         /**
          * Destructor for TabuSearch.
@@ -60,6 +147,12 @@ class TabuSearch {
         ~TabuSearch();
 
         // METHODS
+        /**
+         * Generates the initial solution and allocates the tabu lists
+         * and the candidate lists. The distance matrix must be set.
+         */
+        void initialize();
+
         /**
          * Checks if the pair (city i, city j) is not tabu based on fitness.
          * 
@@ -71,28 +164,101 @@ class TabuSearch {
         bool notTabu(int i, int j, int fitness);
 
         /**
-         * Checks if the solution is not tabu.
-         * 
-         * @param sol Solution to check
-         * @return true if the solution is not tabu, false otherwise
+         * Checks if a move adding the given edges is not tabu based on fitness.
+         *
+         * @param a1, b1 First added edge
+         * @param a2, b2 Second added edge
+         * @param a3, b3 Third added edge (ignored if a3 < 0)
+         * @param fitness Fitness value of the neighbor
+         * @return true if none of the edges is tabu or if the aspiration criterion holds
          */
-        bool notTabu2(Solution* sol);
+        bool notTabuEdges(int a1, int b1, int a2, int b2, int a3, int b3, int fitness);
 
         /**
          * Provides the best non-tabu neighbor using swap.
          * 
-         * @param best_i Best city i
-         * @param best_j Best city j
+         * @param best Best move found so far, updated if a better one is found
          */
-        void neighborhoodSwap(int& best_i, int& best_j);
+        void neighborhoodSwap(Move& best);
 
         /**
          * Provides the best non-tabu neighbor using 2-opt.
          * 
-         * @param best_i Best city i
-         * @param best_j Best city j
+         * @param best Best move found so far, updated if a better one is found
+         */
+        void neighborhood2opt(Move& best);
+
+        /**
+         * Same as neighborhoodSwap() and neighborhood2opt(), with the deltas of
+         * 8 moves of a row computed at once by AVX2 gathers. Requires simdSupported().
+         *
+         * @param best Best move found so far, updated if a better one is found
+         */
+        void neighborhoodSwapSimd(Move& best);
+        void neighborhood2optSimd(Move& best);
+
+        /**
+         * @return true if the processor runs the AVX2 kernels
+         */
+        static bool simdSupported();
+
+        /**
+         * Enables or disables the AVX2 kernels (enabled by default when supported).
+         *
+         * @param enabled true to enable them
+         */
+        void setSimd(bool enabled);
+
+        /**
+         * Provides the best non-tabu neighbor using Or-opt: a path of 1 to 3 cities
+         * is inserted, reversed or not, next to one of its candidate cities.
+         *
+         * @param best Best move found so far, updated if a better one is found
+         */
+        void neighborhoodOrOpt(Move& best);
+
+        /**
+         * Provides the best non-tabu neighbor using restricted 3-opt: two consecutive
+         * paths are exchanged, the new edges being taken from the candidate lists.
+         *
+         * @param best Best move found so far, updated if a better one is found
+         */
+        void neighborhood3opt(Move& best);
+
+        /**
+         * Provides the best non-tabu neighbor among the selected neighbourhoods.
+         *
+         * @param best Best move found, best.type == MOVE_NONE if every move is tabu
+         */
+        void selectMove(Move& best);
+
+        /**
+         * Makes the attributes of a move tabu. Must be called before applying the move.
+         *
+         * @param move Move about to be applied to the current solution
+         */
+        void makeTabu(const Move& move);
+
+        /**
+         * Applies a move to the tour and to the current solution. The fitness is not updated.
+         *
+         * @param move Move to apply
          */
-        void neighborhood2opt(int& best_i, int& best_j);
+        void applyMove(const Move& move);
+
+        /**
+         * XOR of the keys of the edges incident to the given cities.
+         *
+         * @param cities Cities
+         * @param num_cities Number of cities (at most 4)
+         * @return Part of the hash of the tour made of these edges
+         */
+        uint64_t edgesHash(const int *cities, int num_cities);
+
+        /**
+         * Builds the candidate lists (nearest cities) from the distance matrix.
+         */
+        void buildCandidateLists();
 
         /**
          * Constructs the distance matrix.
@@ -103,27 +269,120 @@ class TabuSearch {
         void constructDistance(int nv, const vector<City>& cities);
 
         /**
-         * Adds the solution to the tabu list at the specified position.
+         * Starts the Tabu Search.
          * 
-         * @param sol Solution to add
-         * @param position Position in the tabu list
+         * @return Pointer to the best solution found
          */
-        void updateTabuList2(Solution* sol, int& position);
+        Solution* optimize();
 
         /**
-         * Starts the Tabu Search.
-         * 
+         * Starts the iterated local search: the current solution is improved by
+         * Lin-Kernighan, then each iteration kicks a copy of it with a double bridge,
+         * repairs it from the cities around the kick only, and accepts it or not.
+         * Called by optimize() when an acceptance criterion is set.
+         *
          * @return Pointer to the best solution found
          */
-        Solution* optimize();
+        Solution* iteratedLocalSearch();
 
         /**
-         * Perturbs the solution by swapping a few cities.
+         * Segment-preserving double bridge: exchanges two consecutive paths of at most
+         * max_kick_length cities starting at a random index. Only the two paths are
+         * rewritten, and the variation of the length is computed from the 6 edges changed.
+         *
+         * @param cities Array of the cities in visiting order, kicked in place
+         * @param touched Receives the 6 cities at the ends of the changed edges
+         * @return Variation of the length of the tour
+         */
+        int doubleBridgeKick(int *cities, int *touched);
+
+        /**
+         * Selects the iterated local search instead of the tabu search.
+         *
+         * @param acceptance "better", "walk", "anneal", or "none" for the tabu search
+         * @param max_kick_length Maximum length of the paths exchanged by a kick
+         * @return false if the criterion is unknown
+         */
+        bool setIteratedLocalSearch(const string& acceptance, int max_kick_length);
+
+        /**
+         * Perturbs the solution by swapping a few cities,
+         * then improves it with Lin-Kernighan if enabled.
          */
         void perturb_solution();
 
+        /**
+         * Replaces the initial solution by a tour built by a construction heuristic.
+         *
+         * @param name "random", "nn", "greedy", "sfc" or "savings" (see Construction)
+         * @param start Start city of the nearest neighbour tour
+         * @return false if the name is unknown
+         */
+        bool setConstruction(const string& name, int start);
+
         void setMaxNoImprovementIterations(int value);
         void setNumPerturbationsDenominator(int value);
+
+        /**
+         * Selects the neighbourhoods explored at each iteration.
+         *
+         * @param names Comma separated list among "swap", "2opt", "oropt", "3opt" or "all"
+         * @return false if a name is unknown
+         */
+        bool setNeighborhoods(const string& names);
+        void setNumCandidates(int value);
+
+        /**
+         * Enables or disables the Lin-Kernighan improvement of the perturbed solutions.
+         *
+         * @param enabled true to enable it
+         */
+        void setLinKernighan(bool enabled);
+
+        /**
+         * Enables or disables the reactive tenure: the tenure grows when the search
+         * revisits a solution, and shrinks after a stretch of iterations without
+         * repetition. tabu_duration is the initial tenure.
+         *
+         * @param enabled true to enable it
+         */
+        void setReactive(bool enabled);
+
+        /**
+         * Updates the tenure after a move of the reactive search.
+         */
+        void reactToRepetitions();
+
+        /**
+         * Records the changes of the tenure, written by writeTenureTrace().
+         */
+        void enableTenureTrace();
+
+        /**
+         * Writes the trace of the tenure, one line "iteration tenure" per change.
+         *
+         * @param filename Name of the file
+         * @return false if the file cannot be written
+         */
+        bool writeTenureTrace(const string& filename);
+
+        /**
+         * Shares the search with other threads through an elite pool: the best solution
+         * is published periodically, and the search restarts from a perturbed elite
+         * solution when the perturbations no longer improve it.
+         *
+         * @param pool Elite pool, NULL to search alone
+         * @param publish_interval Number of iterations between two publications
+         * @param max_perturbations_before_restart Perturbations without improvement before a restart
+         */
+        void setElitePool(ElitePool* pool, int publish_interval, int max_perturbations_before_restart);
+
+        /**
+         * Replaces the current solution by a perturbed elite solution.
+         *
+         * @return false if there is no elite solution
+         */
+        bool restart_from_elite();
 };
 
 #endif
@@ -0,0 +1,176 @@
+#include "tabu_search.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TABU_SIMD
+#endif
+
+using namespace std;
+
+/*
+ * AVX2 kernels of the swap and 2-opt neighbourhoods.
+ *
+ * For a fixed first position i, the deltas of the moves (i, j) .. (i, j + 7)
+ * are computed at once: the cities t[j..j+7] and their neighbours are loaded
+ * from wrapped_city, and the distances are gathered from the rows of the
+ * cities of position i, or from the whole matrix (offset b * n + q) when both
+ * cities vary. The distance matrix is symmetric, so d[b][x] is read as d[x][b].
+ *
+ * The lanes that do not beat the best delta (or that are not valid moves)
+ * are masked out with a vector comparison; the tabu status is only checked
+ * for the remaining lanes, in increasing j, so the move selected is exactly
+ * the one of the scalar loops.
+ */
+
+bool TabuSearch::simdSupported() {
+#ifdef TABU_SIMD
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+#ifdef TABU_SIMD
+
+__attribute__((target("avx2")))
+void TabuSearch::neighborhoodSwapSimd(Move &best) {
+    int n = solution_size;
+    const int *t = wrapped_city.data();
+    const int *matrix = distances[0];
+    __m256i vn = _mm256_set1_epi32(n);
+    int deltas[8];
+
+    for(int i = 0; i < n - 1; i++) {
+        int a = t[i], pi = t[(i - 1 + n) % n], ni = t[i + 1];
+        const int *row_a = distances[a], *row_pi = distances[pi], *row_ni = distances[ni];
+        // j = n - 1 and j = n - 2 are excluded when i = 0
+        int last = (i == 0) ? n - 3 : n - 1;
+
+        // Adjacent cities
+        int j = i + 1;
+        if (j <= last) {
+            int b = t[j], nj = t[(j + 1) % n];
+            int delta = row_pi[b] + row_a[nj] - row_pi[a] - distances[b][nj];
+            if(delta < best.delta && notTabu(min(a, b), max(a, b), current->fitness + delta)) {
+                best.type  = MOVE_SWAP;
+                best.a     = a;
+                best.b     = b;
+                best.delta = delta;
+            }
+        }
+
+        __m256i removed = _mm256_set1_epi32(row_pi[a] + row_a[ni]);
+        for (j = i + 2; j + 7 <= last; j += 8) {
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(t + j));
+            __m256i vpj = _mm256_loadu_si256((const __m256i*)(t + j - 1));
+            __m256i vnj = _mm256_loadu_si256((const __m256i*)(t + j + 1));
+            __m256i added = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_i32gather_epi32(row_pi, vb, 4), _mm256_i32gather_epi32(row_ni, vb, 4)),
+                _mm256_add_epi32(_mm256_i32gather_epi32(row_a, vpj, 4), _mm256_i32gather_epi32(row_a, vnj, 4)));
+            __m256i around_b = _mm256_add_epi32(
+                _mm256_i32gather_epi32(matrix, _mm256_add_epi32(_mm256_mullo_epi32(vpj, vn), vb), 4),
+                _mm256_i32gather_epi32(matrix, _mm256_add_epi32(_mm256_mullo_epi32(vb, vn), vnj), 4));
+            __m256i delta = _mm256_sub_epi32(added, _mm256_add_epi32(removed, around_b));
+
+            __m256i better = _mm256_cmpgt_epi32(_mm256_set1_epi32(best.delta), delta);
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(better));
+            if (mask == 0)
+                continue;
+            _mm256_storeu_si256((__m256i*)deltas, delta);
+            for (; mask != 0; mask &= mask - 1) {
+                int lane = __builtin_ctz(mask);
+                int b = t[j + lane];
+                if(deltas[lane] < best.delta && notTabu(min(a, b), max(a, b), current->fitness + deltas[lane])) {
+                    best.type  = MOVE_SWAP;
+                    best.a     = a;
+                    best.b     = b;
+                    best.delta = deltas[lane];
+                }
+            }
+        }
+
+        // Remaining moves of the row
+        for (; j <= last; j++) {
+            int b = t[j], pj = t[j - 1], nj = t[j + 1];
+            int delta = row_pi[b] + row_ni[b] + row_a[pj] + row_a[nj]
+                      - row_pi[a] - row_a[ni] - distances[pj][b] - distances[b][nj];
+            if(delta < best.delta && notTabu(min(a, b), max(a, b), current->fitness + delta)) {
+                best.type  = MOVE_SWAP;
+                best.a     = a;
+                best.b     = b;
+                best.delta = delta;
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void TabuSearch::neighborhood2optSimd(Move &best) {
+    int n = solution_size;
+    const int *t = wrapped_city.data();
+    const int *matrix = distances[0];
+    __m256i vn = _mm256_set1_epi32(n);
+    int deltas[8];
+
+    for(int i = 0; i < n - 1; i++) {
+        int a = t[i], p = t[(i - 1 + n) % n];
+        const int *row_a = distances[a], *row_p = distances[p];
+        __m256i vp = _mm256_set1_epi32(p);
+        __m256i removed = _mm256_set1_epi32(row_p[a]);
+
+        int j = i + 1;
+        for (; j + 7 < n; j += 8) {
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(t + j));
+            __m256i vq = _mm256_loadu_si256((const __m256i*)(t + j + 1));
+            __m256i added = _mm256_add_epi32(_mm256_i32gather_epi32(row_p, vb, 4), _mm256_i32gather_epi32(row_a, vq, 4));
+            __m256i d_bq = _mm256_i32gather_epi32(matrix, _mm256_add_epi32(_mm256_mullo_epi32(vb, vn), vq), 4);
+            __m256i delta = _mm256_sub_epi32(added, _mm256_add_epi32(removed, d_bq));
+
+            // Reversing the whole cycle (or all cities but one) gives the same cycle
+            __m256i same_cycle = _mm256_or_si256(_mm256_cmpeq_epi32(vb, vp), _mm256_cmpeq_epi32(vq, vp));
+            __m256i better = _mm256_andnot_si256(same_cycle, _mm256_cmpgt_epi32(_mm256_set1_epi32(best.delta), delta));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(better));
+            if (mask == 0)
+                continue;
+            _mm256_storeu_si256((__m256i*)deltas, delta);
+            for (; mask != 0; mask &= mask - 1) {
+                int lane = __builtin_ctz(mask);
+                int b = t[j + lane], q = t[j + lane + 1];
+                if(deltas[lane] < best.delta && notTabuEdges(p, b, a, q, -1, -1, current->fitness + deltas[lane])) {
+                    best.type = MOVE_2OPT;
+                    best.a = a;
+                    best.b = b;
+                    best.delta = deltas[lane];
+                }
+            }
+        }
+
+        // Remaining moves of the row
+        for (; j < n; j++) {
+            int b = t[j], q = t[j + 1];
+            if (p == b || p == q)
+                continue;
+            int delta = row_p[b] + row_a[q] - row_p[a] - distances[b][q];
+            if(delta < best.delta && notTabuEdges(p, b, a, q, -1, -1, current->fitness + delta)) {
+                best.type = MOVE_2OPT;
+                best.a = a;
+                best.b = b;
+                best.delta = delta;
+            }
+        }
+    }
+}
+
+#else
+
+void TabuSearch::neighborhoodSwapSimd(Move &best) {
+    use_simd = false;
+    neighborhoodSwap(best);
+}
+
+void TabuSearch::neighborhood2optSimd(Move &best) {
+    use_simd = false;
+    neighborhood2opt(best);
+}
+
+#endif
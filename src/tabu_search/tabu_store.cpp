@@ -0,0 +1,63 @@
+#include "tabu_store.h"
+
+using namespace std;
+
+TabuStore::TabuStore(int capacity) {
+    size_t slots = 16;
+    while ((int)slots < capacity)
+        slots <<= 1;
+    table.assign(slots, Entry());
+    mask = slots - 1;
+    shift = 64;
+    for (size_t s = slots; s > 1; s >>= 1)
+        shift--;
+    clear();
+}
+
+void TabuStore::clear() {
+    for (size_t slot = 0; slot < table.size(); slot++)
+        table[slot].key = 0;
+    used = 0;
+}
+
+void TabuStore::add(int a, int b, int expiry, int iteration) {
+    // At most half of the slots are occupied, so that the probes stay short
+    if (2 * (used + 1) > table.size())
+        rebuild(iteration);
+    insert(make_key(a, b), expiry);
+}
+
+void TabuStore::insert(uint64_t key, int expiry) {
+    size_t slot = index(key);
+    while (table[slot].key != 0 && table[slot].key != key)
+        slot = (slot + 1) & mask;
+    if (table[slot].key == 0)
+        used++;
+    table[slot].key = key;
+    table[slot].expiry = expiry;
+}
+
+/**
+ * Rebuilds the table without the attributes expired before 'iteration'.
+ * The table doubles when more than a quarter of the slots are still tabu.
+ */
+void TabuStore::rebuild(int iteration) {
+    size_t live = 0;
+    for (size_t slot = 0; slot < table.size(); slot++)
+        if (table[slot].key != 0 && table[slot].expiry >= iteration)
+            live++;
+    size_t slots = table.size();
+    while (4 * (live + 1) > slots)
+        slots <<= 1;
+
+    old.swap(table);
+    table.assign(slots, Entry());
+    mask = slots - 1;
+    shift = 64;
+    for (size_t s = slots; s > 1; s >>= 1)
+        shift--;
+    used = 0;
+    for (size_t slot = 0; slot < old.size(); slot++)
+        if (old[slot].key != 0 && old[slot].expiry >= iteration)
+            insert(old[slot].key, old[slot].expiry);
+}
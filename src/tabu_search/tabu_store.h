@@ -0,0 +1,80 @@
+#ifndef _TABU_STORE_H
+#define _TABU_STORE_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * The TabuStore class records tabu attributes made of two cities (a pair of
+ * swapped cities or an edge) with the last iteration at which they are tabu.
+ * The attributes are kept in an open addressing hash table. The expired
+ * attributes are dropped when the table is rebuilt, so its size follows the
+ * number of attributes that are still tabu (a few per iteration of tenure)
+ * instead of the n^2 pairs of cities.
+ */
+class TabuStore {
+    public:
+        /**
+         * Constructor
+         * @param capacity Initial number of slots, rounded up to a power of two
+         */
+        TabuStore(int capacity = 64);
+
+        /**
+         * Makes the pair (a, b) tabu until the iteration 'expiry' included.
+         * The pair is unordered: (b, a) is the same attribute.
+         * @param iteration Current iteration, the attributes expired before it may be dropped
+         */
+        void add(int a, int b, int expiry, int iteration);
+
+        /**
+         * @return true if the pair (a, b) is tabu at the given iteration
+         */
+        bool is_tabu(int a, int b, int iteration) const {
+            uint64_t key = make_key(a, b);
+            for (size_t slot = index(key); table[slot].key != 0; slot = (slot + 1) & mask)
+                if (table[slot].key == key)
+                    return table[slot].expiry >= iteration;
+            return false;
+        }
+
+        /**
+         * Removes all the attributes.
+         */
+        void clear();
+
+        /**
+         * @return Number of slots of the table
+         */
+        size_t capacity() const {
+            return table.size();
+        }
+
+    private:
+        struct Entry {
+            uint64_t key;       ///< Both cities of the attribute, 0 if the slot is empty
+            int expiry;         ///< Last iteration at which the attribute is tabu
+        };
+
+        vector<Entry> table;    ///< Slots, a power of two
+        vector<Entry> old;      ///< Previous slots, reused by rebuild()
+        size_t mask;            ///< Number of slots - 1
+        int shift;              ///< 64 - log2(number of slots)
+        size_t used;            ///< Number of occupied slots, expired attributes included
+
+        static uint64_t make_key(int a, int b) {
+            uint64_t low = (uint64_t)(a < b ? a : b), high = (uint64_t)(a < b ? b : a);
+            return (high << 32 | low) + 1;
+        }
+
+        size_t index(uint64_t key) const {
+            return (size_t)((key * 0x9e3779b97f4a7c15ULL) >> shift);
+        }
+
+        void insert(uint64_t key, int expiry);
+        void rebuild(int iteration);
+};
+
+#endif
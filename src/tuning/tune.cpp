@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../common/options.h"
+#include "../common/tsp_file.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace std;
+
+/**
+ * A parameter of the solver and the values tried, e.g. "stagnation" and {"50", "100"}.
+ */
+struct Parameter {
+    string name;
+    vector<string> values;
+};
+
+/**
+ * A configuration of the solver: the named options given to the executable.
+ */
+struct Configuration {
+    string options;         ///< Named options, e.g. "--stagnation 50 --perturbation 3"
+    vector<double> costs;   ///< Cost on each (run, instance) pair evaluated so far
+    bool alive;             ///< false once the configuration is dropped by the race
+};
+
+/**
+ * A TSP instance and the number of its cities.
+ */
+struct Instance {
+    string file;
+    int size;
+};
+
+/**
+ * One execution of the solver.
+ */
+struct Task {
+    string command;
+    int fitness;            ///< Length of the best tour found, -1 if the run failed
+};
+
+/**
+ * Splits a string at each separator.
+ */
+vector<string> split(const string& text, char separator) {
+    vector<string> parts;
+    stringstream ss(text);
+    string part;
+    while (getline(ss, part, separator))
+        if (!part.empty())
+            parts.push_back(part);
+    return parts;
+}
+
+/**
+ * Parses a grid "name=v1,v2;name=v1,v2,v3".
+ */
+vector<Parameter> parse_grid(const string& grid) {
+    vector<Parameter> parameters;
+    vector<string> items = split(grid, ';');
+    for (size_t k = 0; k < items.size(); k++) {
+        size_t equal = items[k].find('=');
+        if (equal == string::npos) {
+            cerr << "Invalid grid item: " << items[k] << endl;
+            exit(EXIT_FAILURE);
+        }
+        Parameter parameter;
+        parameter.name = items[k].substr(0, equal);
+        parameter.values = split(items[k].substr(equal + 1), ',');
+        parameters.push_back(parameter);
+    }
+    return parameters;
+}
+
+/**
+ * Builds every combination of the values of the parameters.
+ */
+vector<Configuration> build_configurations(const vector<Parameter>& parameters) {
+    vector<Configuration> configurations(1);
+    configurations[0].alive = true;
+    for (size_t p = 0; p < parameters.size(); p++) {
+        vector<Configuration> extended;
+        for (size_t c = 0; c < configurations.size(); c++) {
+            for (size_t v = 0; v < parameters[p].values.size(); v++) {
+                Configuration configuration = configurations[c];
+                if (!configuration.options.empty())
+                    configuration.options += " ";
+                configuration.options += "--" + parameters[p].name + " " + parameters[p].values[v];
+                extended.push_back(configuration);
+            }
+        }
+        configurations = extended;
+    }
+    return configurations;
+}
+
+/**
+ * Runs the solver and reads the length of the best tour it found on the line
+ * "The best solution found is: ..." ("--> X km" for the Tabu Search,
+ * "fitness = X" for the Genetic Algorithm).
+ * @return Length of the tour, -1 if it cannot be read
+ */
+int run_solver(const string& command) {
+    FILE *output = popen(command.c_str(), "r");
+    if (!output)
+        return -1;
+    int fitness = -1;
+    char buffer[4096];
+    string line;
+    while (fgets(buffer, sizeof(buffer), output)) {
+        line += buffer;
+        if (line.empty() || line[line.size() - 1] != '\n')
+            continue;
+        if (line.find("The best solution found is") != string::npos) {
+            size_t arrow = line.rfind("--> ");
+            size_t equal = line.rfind("fitness = ");
+            if (arrow != string::npos)
+                fitness = atoi(line.c_str() + arrow + 4);
+            else if (equal != string::npos)
+                fitness = atoi(line.c_str() + equal + 10);
+        }
+        line.clear();
+    }
+    pclose(output);
+    return fitness;
+}
+
+/**
+ * Runs the tasks on 'num_threads' threads.
+ */
+void run_tasks(vector<Task>& tasks, int num_threads) {
+    atomic<int> next(0);
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.push_back(thread([&tasks, &next]() {
+            for (int k = next++; k < (int)tasks.size(); k = next++)
+                tasks[k].fitness = run_solver(tasks[k].command);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+}
+
+/**
+ * @return Mean of the costs of a configuration
+ */
+double mean_cost(const Configuration& configuration) {
+    double sum = 0;
+    for (size_t k = 0; k < configuration.costs.size(); k++)
+        sum += configuration.costs[k];
+    return configuration.costs.empty() ? 0 : sum / configuration.costs.size();
+}
+
+/**
+ * Paired t statistic of the differences of cost between a configuration and
+ * the best one: large values mean the configuration is worse.
+ */
+double t_statistic(const Configuration& configuration, const Configuration& best) {
+    int k = (int)configuration.costs.size();
+    double mean = 0, square = 0;
+    for (int i = 0; i < k; i++) {
+        double difference = configuration.costs[i] - best.costs[i];
+        mean += difference;
+        square += difference * difference;
+    }
+    mean /= k;
+    double variance = (square - k * mean * mean) / (k - 1);
+    if (variance <= 1e-12)
+        return mean > 1e-12 ? INFINITY : 0;
+    return mean / sqrt(variance / k);
+}
+
+/**
+ * Races the configurations on a set of instances. At each run, every remaining
+ * configuration solves every instance with the same seed, its cost being its tour
+ * length divided by the best length found in this run on the instance. After
+ * 'min_runs' runs, the configurations whose paired t statistic against the
+ * best one exceeds 't_threshold' are dropped.
+ * @return Index of the best configuration
+ */
+int race(vector<Configuration>& configurations, const vector<Instance>& instances, const string& solver,
+         int runs, int min_runs, double t_threshold, unsigned long long seed, int num_threads) {
+    for (size_t c = 0; c < configurations.size(); c++) {
+        configurations[c].alive = true;
+        configurations[c].costs.clear();
+    }
+
+    int best = 0;
+    for (int run = 0; run < runs; run++) {
+        vector<int> alive;
+        for (size_t c = 0; c < configurations.size(); c++)
+            if (configurations[c].alive)
+                alive.push_back((int)c);
+
+        // Every remaining configuration on every instance, with common seeds
+        vector<Task> tasks;
+        for (size_t a = 0; a < alive.size(); a++) {
+            for (size_t i = 0; i < instances.size(); i++) {
+                ostringstream command;
+                command << solver << " " << instances[i].file << " --seed " << seed + run * 1000 + i
+                        << " " << configurations[alive[a]].options;
+                Task task = { command.str(), -1 };
+                tasks.push_back(task);
+            }
+        }
+        run_tasks(tasks, num_threads);
+
+        for (size_t i = 0; i < instances.size(); i++) {
+            int best_fitness = -1;
+            for (size_t a = 0; a < alive.size(); a++) {
+                int fitness = tasks[a * instances.size() + i].fitness;
+                if (fitness < 0) {
+                    cerr << "The run failed: " << tasks[a * instances.size() + i].command << endl;
+                    exit(EXIT_FAILURE);
+                }
+                if (best_fitness < 0 || fitness < best_fitness)
+                    best_fitness = fitness;
+            }
+            for (size_t a = 0; a < alive.size(); a++)
+                configurations[alive[a]].costs.push_back(
+                    (double)tasks[a * instances.size() + i].fitness / max(1, best_fitness));
+        }
+
+        best = alive[0];
+        for (size_t a = 1; a < alive.size(); a++)
+            if (mean_cost(configurations[alive[a]]) < mean_cost(configurations[best]))
+                best = alive[a];
+
+        // Drop the configurations statistically worse than the best one
+        int num_alive = (int)alive.size();
+        if (run + 1 >= min_runs && configurations[best].costs.size() > 1) {
+            for (size_t a = 0; a < alive.size(); a++) {
+                if (alive[a] != best && t_statistic(configurations[alive[a]], configurations[best]) > t_threshold) {
+                    configurations[alive[a]].alive = false;
+                    num_alive--;
+                }
+            }
+        }
+        cout << "  run " << run + 1 << ": " << num_alive << " configuration(s) left, best = "
+             << configurations[best].options << " (mean cost " << mean_cost(configurations[best]) << ")" << endl;
+        if (num_alive == 1)
+            break;
+    }
+    return best;
+}
+
+/**
+ * Tuning tool: races configurations of the Tabu Search or of the Genetic Algorithm
+ * over a set of instances grouped by size class, running the executables in parallel,
+ * and writes the best configuration of each class to a configuration file that
+ * the executables read with --config.
+ *
+ * @param argc number of parameters
+ * @param argv array containing the parameters, all named:
+ *   --algorithm tabu|genetic : solver to tune, default value = tabu
+ *   --instances list         : TSP files (comma separated)
+ *   --grid list              : values tried, "name=v1,v2;name=v1,v2", default value depends on the solver
+ *   --classes list           : upper bounds of the size classes (comma separated), default value = 100,500,2000
+ *   --runs n                 : maximum number of runs per configuration and instance, default value = 10
+ *   --min-runs n             : runs before the first elimination, default value = 3
+ *   --t value                : t statistic above which a configuration is dropped, default value = 2
+ *   --budget n               : iterations (tabu) or generations (genetic) per run
+ *   --threads n              : number of parallel runs (0 = all cores), default value = 0
+ *   --seed n                 : seed of the first run, default value = 1
+ *   --output file            : configuration file written, default value = results/tuned.cfg
+ */
+int main(int argc, char **argv) {
+    Options options(argc, argv);
+
+    string algorithm = options.get("algorithm", "tabu");
+    if (algorithm != "tabu" && algorithm != "genetic") {
+        cerr << "Unknown algorithm: " << algorithm << endl;
+        exit(EXIT_FAILURE);
+    }
+    bool tabu = (algorithm == "tabu");
+    string grid = options.get("grid", tabu ? "stagnation=50,100,150,200;perturbation=3,4,5,6"
+                                           : "population=50,100,200;crossover=0.6,0.8,0.95;mutation=0.2,0.5,0.8");
+    vector<string> files = split(options.get("instances", "data/berlin52.tsp,data/eil76.tsp,data/kroA100.tsp,data/a280.tsp"), ',');
+    vector<string> bounds = split(options.get("classes", "100,500,2000"), ',');
+    int runs = options.get_int("runs", 10);
+    int min_runs = max(2, options.get_int("min-runs", 3));
+    double t_threshold = options.get_double("t", 2.0);
+    int budget = options.get_int("budget", tabu ? 1500 : 20000);
+    int num_threads = options.get_int("threads", 0);
+    if (num_threads <= 0)
+        num_threads = max(1u, thread::hardware_concurrency());
+    unsigned long long seed = strtoull(options.get("seed", "1").c_str(), NULL, 10);
+    string output = options.get("output", "results/tuned.cfg");
+
+#ifdef _WIN32
+    string bin = "bin\\";
+#else
+    string bin = "./bin/";
+#endif
+    // The instance and the named options follow the positional values
+    ostringstream solver;
+    if (tabu)
+        solver << bin << "tabu_search " << budget << " 80";
+    else
+        solver << bin << "genetic_algorithm " << budget << " 100 0.8 0.5";
+
+    vector<Configuration> configurations = build_configurations(parse_grid(grid));
+    cout << "Tuning " << algorithm << ": " << configurations.size() << " configurations, "
+         << num_threads << " parallel runs" << endl;
+
+    // Size classes: ]previous bound, bound], the last one being unbounded
+    vector<int> limits;
+    for (size_t b = 0; b < bounds.size(); b++)
+        limits.push_back(atoi(bounds[b].c_str()));
+    sort(limits.begin(), limits.end());
+    vector<vector<Instance> > classes(limits.size() + 1);
+    for (size_t f = 0; f < files.size(); f++) {
+        vector<City> cities;
+        Instance instance = { files[f], load_tsp_coordinates(files[f], cities) };
+        size_t k = 0;
+        while (k < limits.size() && instance.size > limits[k])
+            k++;
+        classes[k].push_back(instance);
+    }
+
+    ofstream config(output.c_str());
+    if (!config) {
+        cerr << "Unable to write the file " << output << endl;
+        exit(EXIT_FAILURE);
+    }
+    config << "# Configurations tuned by " << argv[0] << " (" << budget << (tabu ? " iterations" : " generations")
+           << " per run)" << endl;
+    config << "# algorithm max_cities options" << endl;
+
+    for (size_t k = 0; k < classes.size(); k++) {
+        if (classes[k].empty())
+            continue;
+        string bound = (k < limits.size()) ? to_string(limits[k]) : "*";
+        cout << endl << "Size class <= " << bound << ":";
+        for (size_t i = 0; i < classes[k].size(); i++)
+            cout << " " << classes[k][i].file << " (" << classes[k][i].size << ")";
+        cout << endl;
+
+        int best = race(configurations, classes[k], solver.str(), runs, min_runs, t_threshold, seed, num_threads);
+        cout << "Best configuration: " << configurations[best].options << endl;
+        config << algorithm << " " << bound << " " << configurations[best].options << endl;
+    }
+    cout << endl << "Configurations written to " << output << endl;
+
+    return 0;
+}